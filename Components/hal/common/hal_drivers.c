@@ -57,6 +57,15 @@
 #if (defined HAL_AES) && (HAL_AES == TRUE)
   #include "hal_aes.h"
 #endif
+#if (defined HAL_CCM_QUEUE) && (HAL_CCM_QUEUE == TRUE)
+  #include "hal_ccm.h"
+#endif
+#if (defined HAL_SNIFFER) && (HAL_SNIFFER == TRUE)
+  #include "hal_sniffer.h"
+#endif
+#if (defined HAL_FLASH_ASYNC) && (HAL_FLASH_ASYNC == TRUE)
+  #include "hal_flash.h"
+#endif
 
 #if (defined HAL_SPI) && (HAL_SPI == TRUE)
   #include "hal_spi.h"
@@ -128,7 +137,7 @@ void HalDriverInit (void)
 {
   /* TIMER */
 #if (defined HAL_TIMER) && (HAL_TIMER == TRUE)
-  #error "The hal timer driver module is removed."
+  HalTimerInit();
 #endif
 
   /* ADC */
@@ -162,6 +171,11 @@ void HalDriverInit (void)
   HalUARTInit();
 #endif
 
+  /* SNIFFER */
+#if (defined HAL_SNIFFER) && (HAL_SNIFFER == TRUE)
+  HalSnifferInit();
+#endif
+
   /* KEY */
 #if (defined HAL_KEY) && (HAL_KEY == TRUE)
   HalKeyInit();
@@ -236,6 +250,38 @@ uint16 Hal_ProcessEvent( uint8 task_id, uint16 events )
     return events ^ HAL_KEY_EVENT;
   }
 
+#if (defined HAL_UART) && (HAL_UART == TRUE)
+  if ( events & HAL_UART_EVENT )
+  {
+    HalUARTProcessEvent();
+    return events ^ HAL_UART_EVENT;
+  }
+#endif
+
+#if (defined HAL_LCD) && (HAL_LCD == TRUE)
+  if ( events & HAL_LCD_EVENT )
+  {
+    HalLcdFlush();
+    return events ^ HAL_LCD_EVENT;
+  }
+#endif
+
+#if (defined HAL_CCM_QUEUE) && (HAL_CCM_QUEUE == TRUE)
+  if ( events & HAL_CCM_EVENT )
+  {
+    HalCcmProcess();
+    return events ^ HAL_CCM_EVENT;
+  }
+#endif
+
+#if (defined HAL_SNIFFER) && (HAL_SNIFFER == TRUE)
+  if ( events & HAL_SNIFFER_EVENT )
+  {
+    HalSnifferProcess();
+    return events ^ HAL_SNIFFER_EVENT;
+  }
+#endif
+
 #ifdef POWER_SAVING
   if ( events & HAL_SLEEP_TIMER_EVENT )
   {
@@ -271,7 +317,7 @@ void Hal_ProcessPoll ()
 
   /* Timer Poll */
 #if (defined HAL_TIMER) && (HAL_TIMER == TRUE)
-  #error "The hal timer driver module is removed."
+  HalTimerTick();
 #endif
 
   /* UART Poll */
@@ -284,6 +330,11 @@ void Hal_ProcessPoll ()
   HalSpiPoll();
 #endif
 
+  /* Flash Poll */
+#if (defined HAL_FLASH_ASYNC) && (HAL_FLASH_ASYNC == TRUE)
+  HalFlashPoll();
+#endif
+
   /* HID poll */
 #if (defined HAL_HID) && (HAL_HID == TRUE)
   usbHidProcessEvents();
@@ -108,6 +108,39 @@ extern "C"
 #define HAL_ADC_REF_DIFF          0xc0    /* AIN7,AIN6 Differential Reference */
 #define HAL_ADC_REF_BITS          0xc0    /* Bits [7:6] */
 
+/* Continuous sampling ring: blocks of samples, each block rounded down to whole sequences */
+#if !defined HAL_ADC_CONT_BLOCKS
+#define HAL_ADC_CONT_BLOCKS        4
+#endif
+#if !defined HAL_ADC_CONT_BLOCK_LEN
+#define HAL_ADC_CONT_BLOCK_LEN     16
+#endif
+
+/**************************************************************************************************
+ * TYPEDEFS
+ **************************************************************************************************/
+
+/* Continuous sampling configuration */
+typedef struct
+{
+  uint8  chanMask;      /* AIN0..AIN7 converted by each trigger, bit n selects AINn */
+  uint8  resolution;    /* HAL_ADC_RESOLUTION_xx */
+  uint16 rate;          /* Sequences per second, 4 and up */
+  uint8  taskId;        /* Task notified when a block is complete */
+  uint16 event;         /* Event set on that task */
+} halAdcContCfg_t;
+
+/* Decimation and IIR filter state, set up by HalAdcFilterInit() */
+typedef struct
+{
+  uint8  decShift;      /* Decimate by 2^decShift with a boxcar (first order CIC) */
+  uint8  iirShift;      /* IIR y += (x - y) / 2^iirShift on the decimated output, 0 is off */
+  uint8  cnt;           /* Samples summed so far */
+  uint32 sum;           /* Boxcar accumulator */
+  uint32 iir;           /* IIR state, y scaled by 2^iirShift */
+  bool   primed;        /* IIR state holds a first output */
+} halAdcFilter_t;
+
 /**************************************************************************************************
  *                                        FUNCTIONS - API
  **************************************************************************************************/
@@ -132,6 +165,44 @@ extern void HalAdcSetReference ( uint8 reference );
  */
 extern bool HalAdcCheckVdd(uint8 vdd);
 
+/*
+ * Read 2^decShift samples and return their sum scaled to decShift/2 extra bits of resolution
+ */
+extern uint16 HalAdcReadOversampled ( uint8 channel, uint8 resolution, uint8 decShift );
+
+/*
+ * Initialize a decimation/IIR filter
+ */
+extern void HalAdcFilterInit ( halAdcFilter_t *filter, uint8 decShift, uint8 iirShift );
+
+/*
+ * Run every stride'th sample of a block through a filter, returns the number of outputs
+ */
+extern uint8 HalAdcFilterBlock ( halAdcFilter_t *filter, const uint16 *in, uint8 len, uint8 stride,
+                                 uint16 *out );
+
+/*
+ * Start continuous sampling of a channel sequence into the DMA ring (HAL_ADC_DMA).
+ * HalAdcRead() must not be used while it runs, and the device must not enter PM2/PM3.
+ */
+extern bool HalAdcContStart ( const halAdcContCfg_t *cfg );
+
+/*
+ * Stop continuous sampling
+ */
+extern void HalAdcContStop ( void );
+
+/*
+ * Copy out the oldest complete block, samples interleaved in channel order.
+ * Returns the number of samples, 0 if no block is ready.
+ */
+extern uint8 HalAdcContRead ( uint16 *buf );
+
+/*
+ * Return and clear the number of blocks dropped because they were not read in time
+ */
+extern uint8 HalAdcContOverrun ( void );
+
 /**************************************************************************************************
 **************************************************************************************************/
 
@@ -45,5 +45,33 @@ Status_t SSP_CCM_Encrypt (uint8, uint8 *, uint8 *, uint16, uint8 *, uint8 *);
 Status_t SSP_CCM_Decrypt (uint8, uint8 *, uint8 *, uint16, uint8 *, uint8 *);
 Status_t SSP_CCM_InvAuth (uint8, uint8 *, uint8 *, uint16, uint8 *, uint16, uint8 *, uint8 *);
 
+#if (defined HAL_CCM_QUEUE) && (HAL_CCM_QUEUE == TRUE)
+/* Queued CCM* jobs, run back to back from the Hal task with the hardware AES fed by DMA.
+ * The nonce is 13 bytes and the length field 2 bytes, as used by the NWK and APS layers.
+ */
+#define HAL_CCM_ENCRYPT   0x00    // Authenticate, then encrypt mData and the MIC
+#define HAL_CCM_DECRYPT   0x01    // Decrypt mData and the MIC, then check it
+
+typedef struct halCcmJob
+{
+  struct halCcmJob *next;         // Owned by the queue from HalCcmSubmit() to the callback
+  uint8  op;                      // HAL_CCM_ENCRYPT or HAL_CCM_DECRYPT
+  uint8  Mval;                    // MIC length: 0, 4, 8 or 16
+  uint8 *key;                     // 16 bytes
+  uint8 *nonce;                   // 13 bytes
+  uint8 *aData;                   // Authenticated only
+  uint16 aLen;
+  uint8 *mData;                   // Authenticated and en/decrypted in place
+  uint16 mLen;
+  uint8 *mic;                     // Mval bytes, written by ENCRYPT and checked by DECRYPT
+  Status_t status;                // SUCCESS, or FAILURE if a DECRYPT MIC did not match
+  void (*cBack)( struct halCcmJob *job );
+} halCcmJob_t;
+
+uint8 HalCcmSubmit( halCcmJob_t *job );
+void HalCcmProcess( void );
+uint8 HalCcmSelfTest( void );
+#endif
+
 #endif  // HAL_CCM_H_
 
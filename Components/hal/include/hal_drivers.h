@@ -63,6 +63,10 @@ extern "C"
 #define HAL_LED_BLINK_EVENT   0x0002
 #define HAL_SLEEP_TIMER_EVENT 0x0004
 #define PERIOD_RSSI_RESET_EVT 0x0008
+#define HAL_UART_EVENT        0x0010
+#define HAL_LCD_EVENT         0x0020
+#define HAL_CCM_EVENT         0x0040
+#define HAL_SNIFFER_EVENT     0x0080
 
 #define PERIOD_RSSI_RESET_TIMEOUT           10
 
@@ -53,6 +53,14 @@ extern "C"
 #include "hal_board.h"
 #include "hal_types.h"
 
+/* ------------------------------------------------------------------------------------------------
+ *                                          Typedefs
+ * ------------------------------------------------------------------------------------------------
+ */
+
+// Called from the Hal task when a queued write or erase is done; 'buf' is NULL for an erase.
+typedef void (*halFlashCBack_t)(uint8 *buf);
+
 /**************************************************************************************************
  * @fn          HalFlashRead
  *
@@ -112,6 +120,102 @@ void HalFlashWrite(uint16 addr, uint8 *buf, uint16 cnt);
  */
 void HalFlashErase(uint8 pg);
 
+#if HAL_FLASH_ASYNC
+/**************************************************************************************************
+ * @fn          HalFlashWriteAsync
+ *
+ * @brief       This function queues a write of 'cnt' 4-byte blocks to the internal flash.
+ *
+ * input parameters
+ *
+ * @param       addr - Valid HAL flash write address: actual addr / 4 and quad-aligned.
+ * @param       buf - Valid buffer space at least as big as 'cnt' X 4, kept until 'cBack'.
+ * @param       cnt - Number of 4-byte blocks to write.
+ * @param       cBack - Completion callback or NULL.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void HalFlashWriteAsync(uint16 addr, uint8 *buf, uint16 cnt, halFlashCBack_t cBack);
+
+/**************************************************************************************************
+ * @fn          HalFlashEraseAsync
+ *
+ * @brief       This function queues an erase of the specified page of the internal flash.
+ *
+ * input parameters
+ *
+ * @param       pg - Valid HAL flash page number (ie < 128) to erase.
+ * @param       cBack - Completion callback or NULL.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void HalFlashEraseAsync(uint8 pg, halFlashCBack_t cBack);
+
+/**************************************************************************************************
+ * @fn          HalFlashPoll
+ *
+ * @brief       This function completes the running request and starts the next one, if any.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void HalFlashPoll(void);
+
+/**************************************************************************************************
+ * @fn          HalFlashFlush
+ *
+ * @brief       This function runs all queued requests to completion.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void HalFlashFlush(void);
+
+/**************************************************************************************************
+ * @fn          HalFlashBusy
+ *
+ * @brief       This function checks for queued requests.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      TRUE if a write or erase is queued or running; FALSE otherwise.
+ **************************************************************************************************
+ */
+bool HalFlashBusy(void);
+#endif
+
 #ifdef __cplusplus
 };
 #endif
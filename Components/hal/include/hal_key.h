@@ -66,6 +66,10 @@ extern "C"
 #define HAL_KEY_STATE_NORMAL          0x00
 #define HAL_KEY_STATE_SHIFT           0x01
 
+/* Key state - press gesture, reported once per gesture in interrupt mode */
+#define HAL_KEY_STATE_LONG            0x02  // Held for HAL_KEY_LONG_MSECS
+#define HAL_KEY_STATE_DOUBLE          0x04  // Pressed again within HAL_KEY_DOUBLE_MSECS
+
 /* Switches (keys) */
 #define HAL_KEY_SW_1 0x01  // Joystick up
 #define HAL_KEY_SW_2 0x02  // Joystick right
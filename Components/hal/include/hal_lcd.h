@@ -126,6 +126,11 @@ extern void HalLcdWriteStringValueValue( char *title, uint16 value1, uint8 forma
  */
 extern void HalLcdDisplayPercentBar( char *title, uint8 value );
 
+/*
+ * Send the changed cells to the LCD
+ */
+extern void HalLcdFlush( void );
+
 
 /**************************************************************************************************
 **************************************************************************************************/
@@ -45,6 +45,73 @@ extern "C"
 {
 #endif
 
+/*********************************************************************
+ * INCLUDES
+ */
+#include "hal_board.h"
+
+/*********************************************************************
+ * CONSTANTS
+ */
+
+/* Power modes accounted by halSleepGetStats(), index of halSleepStats_t.pmTicks[];
+ * halSleep() only ever enters PM2 or PM3, so PM1 has no entry.
+ */
+#define HAL_SLEEP_PM_ACTIVE   0   /* PM0 */
+#define HAL_SLEEP_PM_TIMER    1   /* PM2, woken by the sleep timer or an I/O interrupt */
+#define HAL_SLEEP_PM_DEEP     2   /* PM3, woken by an I/O interrupt only */
+#define HAL_SLEEP_PM_CNT      3
+
+/* Wake causes, index of halSleepStats_t.wakeCnt[] */
+#define HAL_SLEEP_WAKE_OSAL   0   /* Sleep timer set for the next OSAL timer */
+#define HAL_SLEEP_WAKE_MAC    1   /* Sleep timer set for the next MAC timer */
+#define HAL_SLEEP_WAKE_KEY    2   /* Key port interrupt */
+#define HAL_SLEEP_WAKE_UART   3   /* UART flow control edge while the port was suspended */
+#define HAL_SLEEP_WAKE_OTHER  4   /* Any other interrupt or source not recorded */
+#define HAL_SLEEP_WAKE_CNT    5
+#define HAL_SLEEP_WAKE_NONE   0xFF
+
+/*********************************************************************
+ * MACROS
+ */
+
+/* Used by the ISRs that can wake the chip to record the wake cause; the first one wins. */
+#if (defined POWER_SAVING) && (HAL_SLEEP_STATS == TRUE)
+#define HAL_SLEEP_WAKE_SRC(src)  st( if (halSleepWakeSrc == HAL_SLEEP_WAKE_NONE) \
+                                     {                                          \
+                                       halSleepWakeSrc = (src);                 \
+                                     }                                          \
+                                   )
+#else
+#define HAL_SLEEP_WAKE_SRC(src)
+#endif
+
+/*********************************************************************
+ * TYPEDEFS
+ */
+
+typedef struct
+{
+  uint32 pmTicks[HAL_SLEEP_PM_CNT];   /* 32 kHz sleep timer ticks spent in PM0, PM2 and PM3 */
+  uint16 pmCnt[HAL_SLEEP_PM_CNT];     /* Number of times each power mode was entered */
+  uint16 wakeCnt[HAL_SLEEP_WAKE_CNT]; /* Number of wake ups by cause */
+
+  /* Sleep attempts that were given up, counted once each time the reason changes rather than
+   * on every pass of the idle OSAL loop that finds the same reason again.
+   */
+  uint16 vetoIsr;                     /* An ISR cleared the sleep decision during the prep */
+  uint16 vetoMac;                     /* The MAC refused to power off */
+  uint16 tooShort;                    /* The next timeout was below PM_MIN_SLEEP_TIME */
+} halSleepStats_t;
+
+/*********************************************************************
+ * GLOBAL VARIABLES
+ */
+
+#if (defined POWER_SAVING) && (HAL_SLEEP_STATS == TRUE)
+extern volatile uint8 halSleepWakeSrc;
+#endif
+
 /*********************************************************************
  * FUNCTIONS
  */
@@ -69,6 +136,11 @@ extern void halRestoreSleepLevel( void );
  */
 extern void halSleepExit(void);
 
+/*
+ * Copy out the sleep accounting and optionally restart it.
+ */
+extern void halSleepGetStats(halSleepStats_t *stats, uint8 clear);
+
 /*********************************************************************
 *********************************************************************/
 
@@ -0,0 +1,87 @@
+/**************************************************************************************************
+  Filename:       hal_sniffer.h
+
+  Description:    Streams received frames over the UART for packet capture.
+
+
+  Added to this Z-Stack tree in 2026; not part of the Texas Instruments release. It only
+  builds into the Z-Stack and is distributed under the same license as the Texas Instruments
+  sources it is built with, as stated in their file headers (e.g. hal_dma.c).
+**************************************************************************************************/
+
+#ifndef HAL_SNIFFER_H
+#define HAL_SNIFFER_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/***************************************************************************************************
+ *                                            INCLUDES
+ ***************************************************************************************************/
+#include "hal_board.h"
+
+/***************************************************************************************************
+ *                                            CONSTANTS
+ ***************************************************************************************************/
+/*
+ * One record per received frame, all fields little endian:
+ *
+ *   SOF     1   0xFE
+ *   LEN     1   bytes from BACKOFF through the end of PSDU
+ *   BACKOFF 4   MAC backoff count at SFD (320 us units)
+ *   TIMER   2   MAC timer at SFD within that backoff (1/32 us units)
+ *   CHANNEL 1   11 - 26
+ *   RSSI    1   dBm, signed
+ *   LQI     1
+ *   FLAGS   1   HAL_SNIFFER_FLAG_CRC_OK | records dropped just before this one (saturating)
+ *   PSDU    n   frame as received, without the FCS (which the radio replaces)
+ *   FCS     1   XOR of LEN through the end of PSDU
+ */
+#define HAL_SNIFFER_SOF             0xFE
+#define HAL_SNIFFER_HDR_LEN         10
+#define HAL_SNIFFER_FLAG_CRC_OK     0x80
+#define HAL_SNIFFER_DROPS_MAX       0x7F
+
+/***************************************************************************************************
+ *                                             TYPEDEFS
+ ***************************************************************************************************/
+typedef struct
+{
+  uint32 backoff;
+  uint16 timer;
+  uint8  channel;
+  int8   rssi;
+  uint8  lqi;
+  uint8  crcOk;
+} halSnifferHdr_t;
+
+/***************************************************************************************************
+ *                                            FUNCTIONS - API
+ ***************************************************************************************************/
+
+/*
+ * Open the capture port
+ */
+extern void HalSnifferInit ( void );
+
+/*
+ * Queue a frame record, callable from the radio ISR; the PSDU may arrive in two pieces
+ */
+extern void HalSnifferFrame ( halSnifferHdr_t *pHdr, uint8 *p1, uint8 len1, uint8 *p2, uint8 len2 );
+
+/*
+ * Move queued records to the UART, run from the Hal task
+ */
+extern void HalSnifferProcess ( void );
+
+
+/***************************************************************************************************
+***************************************************************************************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
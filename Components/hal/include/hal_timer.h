@@ -59,7 +59,7 @@ extern "C"
 /***************************************************************************************************
  *                                            CONSTANTS
  ***************************************************************************************************/
-/* Timer ID definitions */
+/* Timer ID definitions - on the CC2530 these are Timer 3, Timer 2, Timer 4 and Timer 1 */
 #define HAL_TIMER_0                0x00    // 8bit timer
 #define HAL_TIMER_1                0x01    // 16bit Mac timer
 #define HAL_TIMER_2                0x02    // 8bit timer
@@ -76,10 +76,12 @@ extern "C"
 #define HAL_TIMER_CHANNEL_A        0x02    // Channel A
 #define HAL_TIMER_CHANNEL_B        0x04    // Channel B
 #define HAL_TIMER_CHANNEL_C        0x08    // Channel C
+#define HAL_TIMER_CHANNEL_D        0x10    // Channel D
 #define HAL_TIMER_CHANNEL_MASK    (HAL_TIMER_CHANNEL_SINGLE |  \
                                    HAL_TIMER_CHANNEL_A |       \
                                    HAL_TIMER_CHANNEL_B |       \
-                                   HAL_TIMER_CHANNEL_C)
+                                   HAL_TIMER_CHANNEL_C |       \
+                                   HAL_TIMER_CHANNEL_D)
 
 /* Channel mode definitions */
 #define HAL_TIMER_CH_MODE_INPUT_CAPTURE   0x01    // Channel Mode Input-Capture
@@ -89,6 +91,16 @@ extern "C"
                                            HAL_TIMER_CH_MODE_OUTPUT_COMPARE | \
                                            HAL_TIMER_CH_MODE_OVERFLOW)
 
+/* Channel mode options, or'ed with the channel mode */
+#define HAL_TIMER_CH_CAPTURE_RISE         0x00    // Input-Capture on the rising edge - default
+#define HAL_TIMER_CH_CAPTURE_FALL         0x10    // Input-Capture on the falling edge
+#define HAL_TIMER_CH_CAPTURE_BOTH         0x20    // Input-Capture on both edges
+#define HAL_TIMER_CH_COMPARE_TOGGLE       0x00    // Output-Compare toggles the pin - default
+#define HAL_TIMER_CH_COMPARE_SET          0x10    // Output-Compare sets the pin
+#define HAL_TIMER_CH_COMPARE_CLEAR        0x20    // Output-Compare clears the pin
+#define HAL_TIMER_CH_COMPARE_PWM          0x30    // Set on compare, clear on wrap
+#define HAL_TIMER_CH_OPT_MASK             0x30
+
 /* Error Code */
 #define HAL_TIMER_OK              0x00
 #define HAL_TIMER_NOT_OK          0x01
@@ -97,6 +109,7 @@ extern "C"
 #define HAL_TIMER_INVALID_ID      0x04
 #define HAL_TIMER_INVALID_CH_MODE 0x05
 #define HAL_TIMER_INVALID_OP_MODE 0x06
+#define HAL_TIMER_IN_USE          0x07    // Owned by another driver, i.e. Timer 1 by HAL_ADC_DMA
 
 /* Timer clock pre-scaler definitions for 16bit timer1 and timer3 */
 #define HAL_TIMER3_16_TC_STOP    0x00  // No clock, timer stopped
@@ -179,6 +192,36 @@ extern void HalTimerTick ( void );
  */
 extern uint8 HalTimerInterruptEnable (uint8 timerId, uint8 channelMode, bool enable);
 
+/*
+ * Move the compare point of an Output-Compare channel, in timer ticks
+ */
+extern uint8 HalTimerSetCompare ( uint8 timerId, uint8 channel, uint16 count );
+
+/*
+ * Timestamp, in timer ticks since HalTimerStart(), of the last Input-Capture on a channel
+ */
+extern uint32 HalTimerCaptureGet ( uint8 timerId, uint8 channel );
+
+/*
+ * Current time, in timer ticks since HalTimerStart()
+ */
+extern uint32 HalTimerNow ( uint8 timerId );
+
+/*
+ * Length of a timer tick in 1/32 usec units, i.e. the clock pre-scaler picked by HalTimerStart()
+ */
+extern uint8 HalTimerTickDiv ( uint8 timerId );
+
+/*
+ * DMA trigger raised by the compare event of a channel, see HAL_DMA_TRIG_xxx
+ */
+extern uint8 HalTimerDmaTrigger ( uint8 timerId, uint8 channel );
+
+/*
+ * TRUE while a timer runs; they stop in sleep
+ */
+extern bool HalTimerBusy ( void );
+
 
 /***************************************************************************************************
 ***************************************************************************************************/
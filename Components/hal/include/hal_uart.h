@@ -67,12 +67,16 @@ extern "C"
   
   Note that when using interrupt service based UART configuration (as opposed to DMA)
   higher baudrate such as 115200bps may have problem when radio is operational at the same time.
+  The rates above 115200bps are meant for the DMA driver.
 */
 #define HAL_UART_BR_9600   0x00
 #define HAL_UART_BR_19200  0x01
 #define HAL_UART_BR_38400  0x02
 #define HAL_UART_BR_57600  0x03
 #define HAL_UART_BR_115200 0x04
+#define HAL_UART_BR_230400 0x05
+#define HAL_UART_BR_460800 0x06
+#define HAL_UART_BR_921600 0x07
 
 /* Frame Format constant */
 
@@ -118,6 +122,8 @@ extern "C"
 
 typedef void (*halUARTCBack_t) (uint8 port, uint8 event);
 
+typedef void (*halUARTTxCBack_t) (uint8 port, uint8 *pBuffer, uint16 length);
+
 typedef struct
 {
   // The head or tail is updated by the Tx or Rx ISR respectively, when not polled.
@@ -188,6 +194,11 @@ extern uint16 HalUARTRead ( uint8 port, uint8 *pBuffer, uint16 length );
  */
 extern uint16 HalUARTWrite ( uint8 port, uint8 *pBuffer, uint16 length );
 
+/*
+ * Queue a caller-owned buffer to be sent without copying it - DMA ports only
+ */
+extern uint8 HalUARTWriteAsync ( uint8 port, uint8 *pBuffer, uint16 length, halUARTTxCBack_t txCB );
+
 /*
  * Write a buffer to the UART
  */
@@ -198,6 +209,11 @@ extern uint8 HalUARTIoctl ( uint8 port, uint8 cmd, halUARTIoctl_t *pIoctl );
  */
 extern void HalUARTPoll( void );
 
+/*
+ * Service the UART on HAL_UART_EVENT when it is interrupt driven
+ */
+extern void HalUARTProcessEvent( void );
+
 /*
  * Return the number of bytes in the Rx buffer
  */
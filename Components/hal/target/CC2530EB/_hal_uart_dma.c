@@ -52,6 +52,10 @@
 #include "mt_uart.h"
 #endif
 #include "osal.h"
+#if HAL_UART_DMA_EVT
+#include "hal_drivers.h"
+#include "OSAL_PwrMgr.h"
+#endif
 
 /*********************************************************************
  * MACROS
@@ -184,6 +188,17 @@
 #define HAL_UART_DMA_FULL         (HAL_UART_DMA_RX_MAX - 16)
 #endif
 
+// Depth of the queue of caller-owned buffers given to HalUARTWriteAsync().
+#if !defined HAL_UART_DMA_TX_Q_MAX
+#define HAL_UART_DMA_TX_Q_MAX      4
+#endif
+
+// Msecs between HAL_UART_EVENT runs while an Rx burst is being timed for idle - short enough
+// that the 8-bit sleep timer delta used for the idle countdown cannot wrap between runs.
+#if !defined HAL_UART_DMA_EVT_MSECS
+#define HAL_UART_DMA_EVT_MSECS     2
+#endif
+
 #if defined HAL_BOARD_CC2430EB || defined HAL_BOARD_CC2430DB || defined HAL_BOARD_CC2430BB
 #define HAL_DMA_U0DBUF             0xDFC1
 #define HAL_DMA_U1DBUF             0xDFF9
@@ -220,6 +235,13 @@ typedef uint8 txIdx_t;
 typedef uint16 txIdx_t;
 #endif
 
+typedef struct
+{
+  uint8 *buf;
+  uint16 len;
+  halUARTTxCBack_t txCB;
+} uartDMATxDesc_t;
+
 typedef struct
 {
   uint16 rxBuf[HAL_UART_DMA_RX_MAX];
@@ -241,6 +263,19 @@ typedef struct
   volatile uint8 txShdwValid; // TX shadow value is valid
   uint8 txDMAPending;     // UART TX DMA is pending
 
+  // Caller-owned buffers are sent straight from the caller's memory, in order, one at a time.
+  uartDMATxDesc_t txQ[HAL_UART_DMA_TX_Q_MAX];
+  uint8 txQHead;          // Index of the oldest descriptor, which is the one on (or next to) the DMA.
+  uint8 txQCnt;
+  volatile uint8 txQActive;  // The head descriptor is armed on the TX DMA channel.
+  volatile uint8 txQDone;    // The head descriptor has been sent and awaits its callback.
+
+  uint8 flowCtrl;         // Opened with RTS/CTS, so the peer can be held off across sleep.
+
+#if HAL_UART_DMA_EVT
+  volatile uint8 rxEvt;   // An Rx burst is being serviced; the Rx ISR stays disarmed meanwhile.
+#endif
+
   halUARTCBack_t uartCB;
 } uartDMACfg_t;
 
@@ -271,7 +306,11 @@ static void HalUARTInitDMA(void);
 static void HalUARTOpenDMA(halUARTCfg_t *config);
 static uint16 HalUARTReadDMA(uint8 *buf, uint16 len);
 static uint16 HalUARTWriteDMA(uint8 *buf, uint16 len);
+static uint8 HalUARTWriteAsyncDMA(uint8 *buf, uint16 len, halUARTTxCBack_t txCB);
 static void HalUARTPollDMA(void);
+#if HAL_UART_DMA_EVT
+static void HalUARTSchedDMA(void);
+#endif
 static uint16 HalUARTRxAvailDMA(void);
 static void HalUARTSuspendDMA(void);
 static void HalUARTResumeDMA(void);
@@ -423,16 +462,20 @@ static void HalUARTOpenDMA(halUARTCfg_t *config)
                   (config->baudRate == HAL_UART_BR_19200) ||
                   (config->baudRate == HAL_UART_BR_38400) ||
                   (config->baudRate == HAL_UART_BR_57600) ||
-                  (config->baudRate == HAL_UART_BR_115200));
+                  (config->baudRate == HAL_UART_BR_115200) ||
+                  (config->baudRate == HAL_UART_BR_230400) ||
+                  (config->baudRate == HAL_UART_BR_460800) ||
+                  (config->baudRate == HAL_UART_BR_921600));
   
-  if (config->baudRate == HAL_UART_BR_57600 ||
-      config->baudRate == HAL_UART_BR_115200)
+  if (config->baudRate == HAL_UART_BR_9600 ||
+      config->baudRate == HAL_UART_BR_19200 ||
+      config->baudRate == HAL_UART_BR_38400)
   {
-    UxBAUD = 216;
+    UxBAUD = 59;
   }
   else
   {
-    UxBAUD = 59;
+    UxBAUD = 216;
   }
   
   switch (config->baudRate)
@@ -454,6 +497,18 @@ static void HalUARTOpenDMA(halUARTCfg_t *config)
       UxGCR = 10;
       dmaCfg.txTick = 6;
       break;
+    case HAL_UART_BR_230400:
+      UxGCR = 12;
+      dmaCfg.txTick = 2;
+      break;
+    case HAL_UART_BR_460800:
+      UxGCR = 13;         // 460938bps, +0.03%
+      dmaCfg.txTick = 1;
+      break;
+    case HAL_UART_BR_921600:
+      UxGCR = 14;         // 921875bps, +0.03%
+      dmaCfg.txTick = 1;
+      break;
     default:
       // HAL_UART_BR_115200
       UxGCR = 11;
@@ -461,6 +516,8 @@ static void HalUARTOpenDMA(halUARTCfg_t *config)
       break;
   }
 
+  dmaCfg.flowCtrl = config->flowControl;
+
   // 8 bits/char; no parity; 1 stop bit; stop bit hi.
   if (config->flowControl)
   {
@@ -486,6 +543,26 @@ static void HalUARTOpenDMA(halUARTCfg_t *config)
   // Initialize that TX DMA is not pending
   dmaCfg.txDMAPending = FALSE;
   dmaCfg.txShdwValid = FALSE;
+
+  dmaCfg.txQHead = 0;
+  dmaCfg.txQCnt = 0;
+  dmaCfg.txQActive = FALSE;
+  dmaCfg.txQDone = FALSE;
+
+#if HAL_UART_DMA_EVT
+  // The DMA still moves every byte; the Rx interrupt only wakes the driver on a quiet link.
+  dmaCfg.rxEvt = FALSE;
+  URXxIF = 0;
+  URXxIE = 1;
+
+#if defined POWER_SAVING
+  // Without flow control nothing stops the peer sending while the Rx DMA is stopped in PM2/3.
+  if (!dmaCfg.flowCtrl)
+  {
+    (void)osal_pwrmgr_task_state(Hal_TaskID, PWRMGR_HOLD);
+  }
+#endif
+#endif
 }
 
 /*****************************************************************************
@@ -579,9 +656,60 @@ static uint16 HalUARTWriteDMA(uint8 *buf, uint16 len)
     dmaCfg.txDMAPending = TRUE;
   }
   HAL_EXIT_CRITICAL_SECTION(his);
+
+#if HAL_UART_DMA_EVT
+  osal_set_event(Hal_TaskID, HAL_UART_EVENT);
+#endif
   return cnt;
 }
 
+/******************************************************************************
+ * @fn      HalUARTWriteAsyncDMA
+ *
+ * @brief   Queue a caller-owned buffer to be sent by the TX DMA without copying it.
+ *          Queued buffers take precedence over bytes written later by HalUARTWriteDMA(),
+ *          so a buffer is refused while such bytes are still waiting to be sent in order
+ *          to keep the byte stream in the order in which it was written.
+ *
+ * @param   buf  - pointer to the buffer that will be written, must remain valid and
+ *                 unmodified until txCB is invoked
+ *          len  - length of the buffer, at most 0x1FFF
+ *          txCB - callback invoked from HalUARTPoll() when the buffer has been sent, may be NULL
+ *
+ * @return  HAL_UART_SUCCESS if queued, otherwise HAL_UART_MEM_FAIL and the caller should
+ *          fall back to HalUARTWriteDMA()
+ *****************************************************************************/
+static uint8 HalUARTWriteAsyncDMA(uint8 *buf, uint16 len, halUARTTxCBack_t txCB)
+{
+  uint8 idx;
+  halIntState_t his;
+
+  HAL_UART_ASSERT(len <= 0x1FFF);
+
+  HAL_ENTER_CRITICAL_SECTION(his);
+  if ((dmaCfg.txQCnt >= HAL_UART_DMA_TX_Q_MAX) || (dmaCfg.txIdx[dmaCfg.txSel] != 0))
+  {
+    HAL_EXIT_CRITICAL_SECTION(his);
+    return HAL_UART_MEM_FAIL;
+  }
+
+  idx = dmaCfg.txQHead + dmaCfg.txQCnt;
+  if (idx >= HAL_UART_DMA_TX_Q_MAX)
+  {
+    idx -= HAL_UART_DMA_TX_Q_MAX;
+  }
+  dmaCfg.txQ[idx].buf = buf;
+  dmaCfg.txQ[idx].len = len;
+  dmaCfg.txQ[idx].txCB = txCB;
+  dmaCfg.txQCnt++;
+  HAL_EXIT_CRITICAL_SECTION(his);
+
+#if HAL_UART_DMA_EVT
+  osal_set_event(Hal_TaskID, HAL_UART_EVENT);
+#endif
+  return HAL_UART_SUCCESS;
+}
+
 /******************************************************************************
  * @fn      HalUARTPollDMA
  *
@@ -667,7 +795,48 @@ static void HalUARTPollDMA(void)
     }
   }
   
-  if (dmaCfg.txDMAPending && !dmaCfg.txShdwValid)
+  if (dmaCfg.txQDone)
+  {
+    uartDMATxDesc_t *pDesc = dmaCfg.txQ + dmaCfg.txQHead;
+    halIntState_t his;
+
+    HAL_ENTER_CRITICAL_SECTION(his);
+    dmaCfg.txQDone = FALSE;
+    if (++(dmaCfg.txQHead) >= HAL_UART_DMA_TX_Q_MAX)
+    {
+      dmaCfg.txQHead = 0;
+    }
+    dmaCfg.txQCnt--;
+    HAL_EXIT_CRITICAL_SECTION(his);
+
+    if (pDesc->txCB != NULL)
+    {
+      pDesc->txCB(HAL_UART_DMA-1, pDesc->buf, pDesc->len);
+    }
+  }
+
+  if (dmaCfg.txQCnt && !dmaCfg.txQActive && !dmaCfg.txShdwValid &&
+                                            (dmaCfg.txIdx[(dmaCfg.txSel ^ 1)] == 0))
+  {
+    // The channel is free and no copied buffer is in flight, so hand the caller's buffer
+    // straight to the DMA.
+    halDMADesc_t *ch = HAL_DMA_GET_DESC1234(HAL_DMA_CH_TX);
+    halIntState_t intState;
+
+    HAL_DMA_SET_SOURCE(ch, dmaCfg.txQ[dmaCfg.txQHead].buf);
+    HAL_DMA_SET_LEN(ch, dmaCfg.txQ[dmaCfg.txQHead].len);
+    dmaCfg.txQActive = TRUE;
+    HAL_ENTER_CRITICAL_SECTION(intState);
+    HAL_DMA_ARM_CH(HAL_DMA_CH_TX);
+    do
+    {
+      asm("NOP");
+    } while (!HAL_DMA_CH_ARMED(HAL_DMA_CH_TX));
+    HAL_DMA_CLEAR_IRQ(HAL_DMA_CH_TX);
+    HAL_DMA_MAN_TRIGGER(HAL_DMA_CH_TX);
+    HAL_EXIT_CRITICAL_SECTION(intState);
+  }
+  else if (dmaCfg.txDMAPending && !dmaCfg.txShdwValid && !dmaCfg.txQActive)
   {
     // UART TX DMA is expected to be fired and enough time has lapsed since last DMA ISR
     // to know that DBUF can be overwritten
@@ -695,7 +864,8 @@ static void HalUARTPollDMA(void)
     halIntState_t his;
 
     HAL_ENTER_CRITICAL_SECTION(his);
-    if ((dmaCfg.txIdx[dmaCfg.txSel] != 0) && !HAL_DMA_CH_ARMED(HAL_DMA_CH_TX)
+    if ((dmaCfg.txIdx[dmaCfg.txSel] != 0) && !dmaCfg.txQActive
+                                          && !HAL_DMA_CH_ARMED(HAL_DMA_CH_TX)
                                           && !HAL_DMA_CHECK_IRQ(HAL_DMA_CH_TX))
     {
       HAL_EXIT_CRITICAL_SECTION(his);
@@ -711,8 +881,69 @@ static void HalUARTPollDMA(void)
   {
     dmaCfg.uartCB(HAL_UART_DMA-1, evt);
   }
+
+#if HAL_UART_DMA_EVT
+  HalUARTSchedDMA();
+#endif
 }
 
+#if HAL_UART_DMA_EVT
+/******************************************************************************
+ * @fn      HalUARTSchedDMA
+ *
+ * @brief   Nothing polls the port in this mode, so arrange for HalUARTPollDMA() to run again
+ *          only while there is Tx or Rx work in progress; a quiet link costs no CPU at all.
+ *
+ * @param   none
+ *
+ * @return  none
+ *****************************************************************************/
+static void HalUARTSchedDMA(void)
+{
+  uint8 txWait = (dmaCfg.txDMAPending || (dmaCfg.txQCnt && !dmaCfg.txQActive));
+
+  // A Tx DMA in flight posts the event itself from HalUARTIsrDMA() when it completes.
+  if (dmaCfg.txQActive || (dmaCfg.txIdx[(dmaCfg.txSel ^ 1)] != 0))
+  {
+    txWait = FALSE;
+  }
+
+  if (txWait && !dmaCfg.txShdwValid)
+  {
+    osal_set_event(Hal_TaskID, HAL_UART_EVENT);
+  }
+  else if (txWait || dmaCfg.rxTick || HAL_UART_DMA_NEW_RX_BYTE(dmaCfg.rxHead))
+  {
+    // Waiting out the 1-character margin after the last Tx DMA, timing an Rx burst for idle,
+    // or waiting for the owner to read what it was told about.
+    osal_start_timerEx(Hal_TaskID, HAL_UART_EVENT, HAL_UART_DMA_EVT_MSECS);
+  }
+  else
+  {
+    // The link is quiet and drained, so re-arm the Rx interrupt for the next 1st byte.
+    dmaCfg.rxEvt = FALSE;
+    URXxIF = 0;
+    URXxIE = 1;
+
+    // Catch a byte that landed before the interrupt was re-armed.
+    if (HAL_UART_DMA_NEW_RX_BYTE(dmaCfg.rxHead))
+    {
+      URXxIE = 0;
+      dmaCfg.rxEvt = TRUE;
+      osal_set_event(Hal_TaskID, HAL_UART_EVENT);
+    }
+  }
+
+#if defined POWER_SAVING
+  // Rx DMA stops in PM2/3, so stay awake while a frame is on the wire or the Tx DMA is busy -
+  // and for good on a port without flow control, where the peer cannot be held off by RTS.
+  (void)osal_pwrmgr_task_state(Hal_TaskID, (!dmaCfg.flowCtrl || dmaCfg.rxEvt || dmaCfg.txQCnt ||
+                               (dmaCfg.txIdx[0] != 0) || (dmaCfg.txIdx[1] != 0)) ?
+                               PWRMGR_HOLD : PWRMGR_CONSERVE);
+#endif
+}
+#endif
+
 /**************************************************************************************************
  * @fn      HalUARTRxAvailDMA()
  *
@@ -753,9 +984,13 @@ static uint16 HalUARTRxAvailDMA(void)
  *****************************************************************************/
 static void HalUARTSuspendDMA( void )
 {
-  PxOUT |= HAL_UART_Px_RTS;  // Disable Rx flow.
-  UxCSR &= ~CSR_RE;
-  P0IEN |=  HAL_UART_Px_CTS;  // Enable the CTS ISR.
+  // Without RTS/CTS the peer cannot be held off nor wake us, so such a port is never suspended.
+  if (dmaCfg.flowCtrl)
+  {
+    PxOUT |= HAL_UART_Px_RTS;  // Disable Rx flow.
+    UxCSR &= ~CSR_RE;
+    P0IEN |=  HAL_UART_WAKE_P0_BIT;  // Enable the CTS ISR.
+  }
 }
 
 /******************************************************************************
@@ -769,10 +1004,13 @@ static void HalUARTSuspendDMA( void )
  *****************************************************************************/
 static void HalUARTResumeDMA( void )
 {
-  P0IEN &= ~HAL_UART_Px_CTS;  // Disable the CTS ISR.
-  UxUCR |= UCR_FLUSH;
-  UxCSR |= CSR_RE;
-  PxOUT &= ~HAL_UART_Px_RTS;  // Re-enable Rx flow.
+  if (dmaCfg.flowCtrl)
+  {
+    P0IEN &= ~HAL_UART_WAKE_P0_BIT;  // Disable the CTS ISR.
+    UxUCR |= UCR_FLUSH;
+    UxCSR |= CSR_RE;
+    PxOUT &= ~HAL_UART_Px_RTS;  // Re-enable Rx flow.
+  }
 }
 
 /******************************************************************************
@@ -789,6 +1027,25 @@ void HalUARTIsrDMA(void)
 {
   HAL_DMA_CLEAR_IRQ(HAL_DMA_CH_TX);
 
+  if (dmaCfg.txQActive)
+  {
+    // A caller-owned buffer is done - its callback is run from HalUARTPollDMA().
+    dmaCfg.txQActive = FALSE;
+    dmaCfg.txQDone = TRUE;
+    dmaCfg.txMT = TRUE;
+    dmaCfg.txShdw = ST0;
+    dmaCfg.txShdwValid = TRUE;
+
+    if (dmaCfg.txIdx[dmaCfg.txSel])
+    {
+      dmaCfg.txDMAPending = TRUE;
+    }
+#if HAL_UART_DMA_EVT
+    osal_set_event(Hal_TaskID, HAL_UART_EVENT);
+#endif
+    return;
+  }
+
   // Indicate that the other buffer is free now.
   dmaCfg.txIdx[(dmaCfg.txSel ^ 1)] = 0;
   dmaCfg.txMT = TRUE;
@@ -803,7 +1060,40 @@ void HalUARTIsrDMA(void)
     // UART TX DMA is expected to be fired
     dmaCfg.txDMAPending = TRUE;
   }
+
+#if HAL_UART_DMA_EVT
+  osal_set_event(Hal_TaskID, HAL_UART_EVENT);
+#endif
+}
+
+#if HAL_UART_DMA_EVT
+/***************************************************************************************************
+ * @fn      halUartRxDmaIsr
+ *
+ * @brief   UART Receive Interrupt - the DMA has already stored the byte, so this only posts
+ *          HAL_UART_EVENT for the 1st byte received on a quiet link and then disarms itself
+ *          until HalUARTSchedDMA() finds the link quiet and drained again.
+ *
+ * @param   None
+ *
+ * @return  None
+ ***************************************************************************************************/
+#if (HAL_UART_DMA == 1)
+HAL_ISR_FUNCTION( halUart0RxDmaIsr, URX0_VECTOR )
+#else
+HAL_ISR_FUNCTION( halUart1RxDmaIsr, URX1_VECTOR )
+#endif
+{
+  HAL_ENTER_ISR();
+
+  URXxIE = 0;
+  dmaCfg.rxEvt = TRUE;
+  osal_set_event(Hal_TaskID, HAL_UART_EVENT);
+
+  CLEAR_SLEEP_MODE();
+  HAL_EXIT_ISR();
 }
+#endif
 
 /******************************************************************************
 ******************************************************************************/
@@ -295,16 +295,20 @@ static void HalUARTOpenISR(halUARTCfg_t *config)
                   (config->baudRate == HAL_UART_BR_19200) ||
                   (config->baudRate == HAL_UART_BR_38400) ||
                   (config->baudRate == HAL_UART_BR_57600) ||
-                  (config->baudRate == HAL_UART_BR_115200));
+                  (config->baudRate == HAL_UART_BR_115200) ||
+                  (config->baudRate == HAL_UART_BR_230400) ||
+                  (config->baudRate == HAL_UART_BR_460800) ||
+                  (config->baudRate == HAL_UART_BR_921600));
   
-  if (config->baudRate == HAL_UART_BR_57600 ||
-      config->baudRate == HAL_UART_BR_115200)
+  if (config->baudRate == HAL_UART_BR_9600 ||
+      config->baudRate == HAL_UART_BR_19200 ||
+      config->baudRate == HAL_UART_BR_38400)
   {
-    UxBAUD = 216;
+    UxBAUD = 59;
   }
   else
   {
-    UxBAUD = 59;
+    UxBAUD = 216;
   }
   
   switch (config->baudRate)
@@ -319,6 +323,15 @@ static void HalUARTOpenISR(halUARTCfg_t *config)
     case HAL_UART_BR_57600:
       UxGCR = 10;
       break;
+    case HAL_UART_BR_230400:
+      UxGCR = 12;
+      break;
+    case HAL_UART_BR_460800:
+      UxGCR = 13;
+      break;
+    case HAL_UART_BR_921600:
+      UxGCR = 14;
+      break;
     default:
       UxGCR = 11;
       break;
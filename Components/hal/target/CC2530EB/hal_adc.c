@@ -45,6 +45,13 @@
 #include  "hal_defs.h"
 #include  "hal_mcu.h"
 #include  "hal_types.h"
+#if (HAL_ADC_DMA == TRUE)
+#include  "hal_dma.h"
+#include  "osal.h"
+#if !HAL_DMA_ALLOC_FREE
+#error HAL_ADC_DMA needs a channel from HalDmaAlloc(), but AES and the UART/SPI hold them all.
+#endif
+#endif
 
 /**************************************************************************************************
  *                                            CONSTANTS
@@ -56,6 +63,7 @@
 #define HAL_ADC_STSEL_FULL  0x10    /* Full Speed, No Trigger */
 #define HAL_ADC_STSEL_T1C0  0x20    /* Timer1, Channel 0 Compare Event Trigger */
 #define HAL_ADC_STSEL_ST    0x30    /* ADCCON1.ST =1 Trigger */
+#define HAL_ADC_STSEL_BITS  0x30    /* Bits [5:4] */
 
 #define HAL_ADC_RAND_NORM   0x00    /* Normal Operation */
 #define HAL_ADC_RAND_LFSR   0x04    /* Clock LFSR */
@@ -76,6 +84,17 @@
 #define HAL_ADC_SCHN        HAL_ADC_CHN_VDD3
 #define HAL_ADC_ECHN        HAL_ADC_CHN_GND
 
+/* Filtering - 2^6 samples of 13 bits keep 3 extra bits within 16 */
+#define HAL_ADC_DEC_SHIFT_MAX   6
+#define HAL_ADC_IIR_SHIFT_MAX   8
+
+/* Continuous sampling */
+#define HAL_ADC_DMA_ADCL    0x70BA  /* XDATA mapped ADCL, ADCH follows */
+#define HAL_ADC_T1_HZ       250000  /* 32 MHz tick divided by 128 */
+#define HAL_ADC_T1_DIV_128  0x0C    /* T1CTL.DIV */
+#define HAL_ADC_T1_MODULO   0x02    /* T1CTL.MODE - count 0..T1CC0 */
+#define HAL_ADC_T1_COMPARE  0x04    /* T1CCTLn.MODE */
+
 /* ------------------------------------------------------------------------------------------------
  *                                       Local Variables
  * ------------------------------------------------------------------------------------------------
@@ -85,6 +104,28 @@
 static uint8 adcRef;
 #endif
 
+#if (HAL_ADC_DMA == TRUE)
+static uint16 adcContBuf[HAL_ADC_CONT_BLOCKS][HAL_ADC_CONT_BLOCK_LEN];
+static uint8 adcContCh = HAL_DMA_CH_NONE;
+static uint8 adcContLen;              /* Samples per block, whole sequences */
+static uint8 adcContShift;            /* Right shift of a sample for the resolution */
+static uint8 adcContTaskId;
+static uint16 adcContEvent;
+static uint8 adcContFill;             /* Block the DMA is writing */
+static volatile uint8 adcContRd;      /* Oldest complete block */
+static volatile uint8 adcContCnt;     /* Complete blocks, the block being filled excluded */
+static volatile uint8 adcContOvf;     /* Blocks dropped since last HalAdcContOverrun() */
+#endif
+
+/* ------------------------------------------------------------------------------------------------
+ *                                       Local Functions
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#if (HAL_ADC_DMA == TRUE)
+static void halAdcDmaCB(uint8 ch);
+#endif
+
 /**************************************************************************************************
  * @fn      HalAdcInit
  *
@@ -236,5 +277,349 @@ bool HalAdcCheckVdd(uint8 vdd)
   return (ADCH > vdd);
 }
 
+#if (HAL_ADC == TRUE)
+/**************************************************************************************************
+ * @fn      HalAdcReadOversampled
+ *
+ * @brief   Read a channel 2^decShift times and decimate the readings with a boxcar. White noise
+ *          averages out so that every 4x oversampling yields one more bit of resolution.
+ *
+ * @param   channel - channel where ADC will be read
+ * @param   resolution - the resolution of each reading
+ * @param   decShift - log2 of the number of readings, up to 6
+ *
+ * @return  Reading with decShift/2 bits more than the given resolution
+ **************************************************************************************************/
+uint16 HalAdcReadOversampled (uint8 channel, uint8 resolution, uint8 decShift)
+{
+  uint32 sum = 0;
+  uint8 i;
+
+  if (decShift > HAL_ADC_DEC_SHIFT_MAX)
+  {
+    decShift = HAL_ADC_DEC_SHIFT_MAX;
+  }
+
+  for (i = 0; i < ((uint8)1 << decShift); i++)
+  {
+    sum += HalAdcRead(channel, resolution);
+  }
+
+  return ((uint16)(sum >> (decShift - decShift / 2)));
+}
+
+/**************************************************************************************************
+ * @fn      HalAdcFilterInit
+ *
+ * @brief   Initialize a boxcar decimator followed by a first order IIR low pass
+ *
+ * @param   filter - filter state
+ * @param   decShift - decimate by 2^decShift, up to 6, keeping decShift/2 extra bits
+ * @param   iirShift - IIR time constant of 2^iirShift outputs, up to 8, 0 disables the IIR
+ *
+ * @return  None
+ **************************************************************************************************/
+void HalAdcFilterInit (halAdcFilter_t *filter, uint8 decShift, uint8 iirShift)
+{
+  filter->decShift = (decShift > HAL_ADC_DEC_SHIFT_MAX) ? HAL_ADC_DEC_SHIFT_MAX : decShift;
+  filter->iirShift = (iirShift > HAL_ADC_IIR_SHIFT_MAX) ? HAL_ADC_IIR_SHIFT_MAX : iirShift;
+  filter->cnt = 0;
+  filter->sum = 0;
+  filter->iir = 0;
+  filter->primed = FALSE;
+}
+
+/**************************************************************************************************
+ * @fn      HalAdcFilterBlock
+ *
+ * @brief   Run samples through a filter. The decimator and the IIR only add and shift, so the
+ *          per-sample cost is one 32-bit add except on the samples that complete an output.
+ *
+ * @param   filter - filter state from HalAdcFilterInit()
+ * @param   in - samples, e.g. a block from HalAdcContRead() offset to one channel
+ * @param   len - number of entries in 'in'
+ * @param   stride - use every stride'th entry, the channel count of an interleaved block
+ * @param   out - room for len / stride / 2^decShift + 1 outputs
+ *
+ * @return  Number of outputs written
+ **************************************************************************************************/
+uint8 HalAdcFilterBlock (halAdcFilter_t *filter, const uint16 *in, uint8 len, uint8 stride,
+                         uint16 *out)
+{
+  uint16 i, y;
+  uint8 cnt = 0;
+
+  if (stride == 0)
+  {
+    stride = 1;
+  }
+
+  for (i = 0; i < len; i += stride)
+  {
+    filter->sum += in[i];
+    if (++filter->cnt < ((uint8)1 << filter->decShift))
+    {
+      continue;
+    }
+
+    y = (uint16)(filter->sum >> (filter->decShift - filter->decShift / 2));
+    filter->sum = 0;
+    filter->cnt = 0;
+
+    if (filter->iirShift)
+    {
+      if (filter->primed)
+      {
+        filter->iir = filter->iir - (filter->iir >> filter->iirShift) + y;
+      }
+      else
+      {
+        filter->iir = (uint32)y << filter->iirShift;
+        filter->primed = TRUE;
+      }
+      y = (uint16)(filter->iir >> filter->iirShift);
+    }
+
+    out[cnt++] = y;
+  }
+
+  return cnt;
+}
+#endif
+
+#if (HAL_ADC_DMA == TRUE)
+/**************************************************************************************************
+ * @fn      HalAdcContStart
+ *
+ * @brief   Start converting a channel sequence on every Timer 1 channel 0 compare. Each result
+ *          is moved by DMA into the current block of the ring and the registered event is set
+ *          whenever a block is complete. The oldest block is dropped if the ring is full.
+ *
+ * @param   cfg - channels, resolution, rate and the task/event to notify
+ *
+ * @return  TRUE if sampling was started, FALSE on a bad configuration or no free DMA channel
+ *
+ *          Note that a sequence must convert within one period: each conversion takes
+ *          (decimation + 16) ADC clocks at 4 MHz.
+ **************************************************************************************************/
+bool HalAdcContStart ( const halAdcContCfg_t *cfg )
+{
+  halDMADesc_t *ch;
+  uint16 period;
+  uint8 resbits, seqLen = 0, endChn = 0, i;
+
+  if ((cfg->chanMask == 0) || (cfg->rate < (HAL_ADC_T1_HZ / 0xFFFF) + 1))
+  {
+    return FALSE;
+  }
+
+  for (i = 0; i < 8; i++)
+  {
+    if (cfg->chanMask & (1 << i))
+    {
+      seqLen++;
+      endChn = i;
+    }
+  }
+
+  HalAdcContStop();
+
+  adcContCh = HalDmaAlloc(1, HAL_DMA_PRI_HIGH, halAdcDmaCB);
+  if (adcContCh == HAL_DMA_CH_NONE)
+  {
+    return FALSE;
+  }
+  ch = HAL_DMA_GET_DESC1234( adcContCh );
+
+  switch (cfg->resolution)
+  {
+    case HAL_ADC_RESOLUTION_8:
+      resbits = HAL_ADC_DEC_064;
+      adcContShift = 8;
+      break;
+    case HAL_ADC_RESOLUTION_10:
+      resbits = HAL_ADC_DEC_128;
+      adcContShift = 6;
+      break;
+    case HAL_ADC_RESOLUTION_12:
+      resbits = HAL_ADC_DEC_256;
+      adcContShift = 4;
+      break;
+    case HAL_ADC_RESOLUTION_14:
+    default:
+      resbits = HAL_ADC_DEC_512;
+      adcContShift = 2;
+      break;
+  }
+
+  adcContLen = (HAL_ADC_CONT_BLOCK_LEN / seqLen) * seqLen;
+  adcContTaskId = cfg->taskId;
+  adcContEvent = cfg->event;
+  adcContFill = 0;
+  adcContRd = 0;
+  adcContCnt = 0;
+  adcContOvf = 0;
+
+  /* One 16-bit result per conversion of the sequence */
+  HAL_DMA_SET_SOURCE( ch, HAL_ADC_DMA_ADCL );
+  HAL_DMA_SET_DEST( ch, adcContBuf[0] );
+  HAL_DMA_SET_VLEN( ch, HAL_DMA_VLEN_USE_LEN );
+  HAL_DMA_SET_LEN( ch, adcContLen );
+  HAL_DMA_SET_WORD_SIZE( ch, HAL_DMA_WORDSIZE_WORD );
+  HAL_DMA_SET_TRIG_MODE( ch, HAL_DMA_TMODE_SINGLE );
+  HAL_DMA_SET_TRIG_SRC( ch, HAL_DMA_TRIG_ADC_CHALL );
+  HAL_DMA_SET_SRC_INC( ch, HAL_DMA_SRCINC_0 );
+  HAL_DMA_SET_DST_INC( ch, HAL_DMA_DSTINC_1 );
+  HAL_DMA_SET_IRQ( ch, HAL_DMA_IRQMASK_ENABLE );
+  HAL_DMA_SET_M8( ch, HAL_DMA_M8_USE_8_BITS );
+  HAL_DMA_SET_PRIORITY( ch, HAL_DMA_PRI_HIGH );
+  HAL_DMA_CLEAR_IRQ( adcContCh );
+  HAL_DMA_ARM_CH( adcContCh );
+
+  /* Channels left out of ADCCFG are skipped by the sequence AIN0..endChn */
+  ADCCFG |= cfg->chanMask;
+  ADCCON2 = adcRef | resbits | endChn;
+  ADCCON1 = (ADCCON1 & ~HAL_ADC_STSEL_BITS) | HAL_ADC_STSEL_T1C0;
+
+  period = (uint16)(HAL_ADC_T1_HZ / cfg->rate) - 1;
+  T1CC0L = (uint8)period;
+  T1CC0H = (uint8)(period >> 8);
+  T1CCTL0 = HAL_ADC_T1_COMPARE;
+  T1CNTL = 0;                                      /* Writing any value clears the counter */
+  T1CTL = HAL_ADC_T1_DIV_128 | HAL_ADC_T1_MODULO;
+
+  return TRUE;
+}
+
+/**************************************************************************************************
+ * @fn      HalAdcContStop
+ *
+ * @brief   Stop continuous sampling, complete blocks can still be read
+ *
+ * @param   None
+ *
+ * @return  None
+ **************************************************************************************************/
+void HalAdcContStop ( void )
+{
+  T1CTL = 0;
+  T1CCTL0 = 0;
+  ADCCON1 = (ADCCON1 & ~HAL_ADC_STSEL_BITS) | HAL_ADC_STSEL_ST;
+
+  if (adcContCh != HAL_DMA_CH_NONE)
+  {
+    HalDmaFree(adcContCh, 1);
+    adcContCh = HAL_DMA_CH_NONE;
+  }
+}
+
+/**************************************************************************************************
+ * @fn      HalAdcContRead
+ *
+ * @brief   Copy out the oldest complete block at the configured resolution
+ *
+ * @param   buf - room for HAL_ADC_CONT_BLOCK_LEN samples
+ *
+ * @return  Number of samples copied, 0 if no block is ready
+ **************************************************************************************************/
+uint8 HalAdcContRead ( uint16 *buf )
+{
+  halIntState_t intState;
+  uint8 i, len = 0;
+
+  HAL_ENTER_CRITICAL_SECTION(intState);
+  if (adcContCnt)
+  {
+    len = adcContLen;
+    for (i = 0; i < len; i++)
+    {
+      buf[i] = adcContBuf[adcContRd][i];
+    }
+    if (++adcContRd == HAL_ADC_CONT_BLOCKS)
+    {
+      adcContRd = 0;
+    }
+    adcContCnt--;
+  }
+  HAL_EXIT_CRITICAL_SECTION(intState);
+
+  for (i = 0; i < len; i++)
+  {
+    /* Treat small negative as 0 */
+    if ((int16)buf[i] < 0)
+    {
+      buf[i] = 0;
+    }
+    buf[i] >>= adcContShift;
+  }
+
+  return len;
+}
+
+/**************************************************************************************************
+ * @fn      HalAdcContOverrun
+ *
+ * @brief   Return and clear the number of blocks dropped because the ring was full
+ *
+ * @param   None
+ *
+ * @return  Blocks dropped, saturates at 255
+ **************************************************************************************************/
+uint8 HalAdcContOverrun ( void )
+{
+  halIntState_t intState;
+  uint8 ovf;
+
+  HAL_ENTER_CRITICAL_SECTION(intState);
+  ovf = adcContOvf;
+  adcContOvf = 0;
+  HAL_EXIT_CRITICAL_SECTION(intState);
+
+  return ovf;
+}
+
+/**************************************************************************************************
+ * @fn      halAdcDmaCB
+ *
+ * @brief   Called from the DMA ISR when a block is complete. The block ends on a sequence
+ *          boundary, so the channel is re-armed well before the next trigger.
+ *
+ * @param   dmaCh - DMA channel of the sampler
+ *
+ * @return  None
+ **************************************************************************************************/
+static void halAdcDmaCB ( uint8 dmaCh )
+{
+  halDMADesc_t *ch = HAL_DMA_GET_DESC1234( dmaCh );
+
+  if (++adcContFill == HAL_ADC_CONT_BLOCKS)
+  {
+    adcContFill = 0;
+  }
+
+  HAL_DMA_SET_DEST( ch, adcContBuf[adcContFill] );
+  HAL_DMA_ARM_CH( dmaCh );
+
+  if (adcContCnt == HAL_ADC_CONT_BLOCKS - 1)
+  {
+    /* The block now being filled was the oldest one */
+    if (++adcContRd == HAL_ADC_CONT_BLOCKS)
+    {
+      adcContRd = 0;
+    }
+    if (adcContOvf != 0xFF)
+    {
+      adcContOvf++;
+    }
+  }
+  else
+  {
+    adcContCnt++;
+  }
+
+  osal_set_event(adcContTaskId, adcContEvent);
+}
+#endif
+
 /**************************************************************************************************
 **************************************************************************************************/
@@ -410,11 +410,28 @@ st( \
 #define HAL_DMA TRUE
 #endif
 
+/* Set to TRUE enable continuous ADC sampling by Timer 1 and DMA, FALSE disable it */
+#ifndef HAL_ADC_DMA
+#define HAL_ADC_DMA FALSE
+#endif
+#if (HAL_ADC_DMA == TRUE) && ((HAL_ADC != TRUE) || (HAL_DMA != TRUE))
+#error HAL_ADC_DMA requires HAL_ADC and HAL_DMA.
+#endif
+
 /* Set to TRUE enable Flash access, FALSE disable it */
 #ifndef HAL_FLASH
 #define HAL_FLASH TRUE
 #endif
 
+/* Set to TRUE to queue flash writes/erases and run them from the Hal task, FALSE disable it */
+#ifndef HAL_FLASH_ASYNC
+#if (HAL_DMA == TRUE) && !HAL_OAD_BOOT_CODE && !HAL_OTA_BOOT_CODE
+#define HAL_FLASH_ASYNC TRUE
+#else
+#define HAL_FLASH_ASYNC FALSE
+#endif
+#endif
+
 /* Set to TRUE enable AES usage, FALSE disable it */
 #ifndef HAL_AES
 #define HAL_AES TRUE
@@ -424,6 +441,16 @@ st( \
 #define HAL_AES_DMA TRUE
 #endif
 
+/* Set to TRUE to queue CCM jobs and run them by DMA from the Hal task, FALSE disable it.
+ * Off until verified on target: jobs only take the DMA path once HalCcmSelfTest() passes.
+ */
+#ifndef HAL_CCM_QUEUE
+#define HAL_CCM_QUEUE FALSE
+#endif
+#if (HAL_CCM_QUEUE == TRUE) && ((HAL_AES != TRUE) || (HAL_AES_DMA != TRUE) || (HAL_DMA != TRUE))
+#error HAL_CCM_QUEUE requires HAL_AES, HAL_AES_DMA and HAL_DMA.
+#endif
+
 /* Set to TRUE enable LCD usage, FALSE disable it */
 #ifndef HAL_LCD
 #define HAL_LCD FALSE
@@ -478,6 +505,19 @@ st( \
 #error HAL_UART_DMA & HAL_UART_ISR must be different.
 #endif
 
+// Service the DMA UART from its Rx/Tx interrupts by HAL_UART_EVENT instead of polling it on every
+// pass of the OSAL loop; power saving builds default to this so the link can idle between frames.
+#ifndef HAL_UART_DMA_EVT
+#if (defined POWER_SAVING) && HAL_UART_DMA
+#define HAL_UART_DMA_EVT  TRUE
+#else
+#define HAL_UART_DMA_EVT  FALSE
+#endif
+#endif
+
+// Port 0 pin that HalUARTSuspend() arms to wake on the peer's flow control while asleep.
+#define HAL_UART_WAKE_P0_BIT  BV(4)
+
 // Used to set P2 priority - USART0 over USART1 if both are defined.
 #if ((HAL_UART_DMA == 1) || (HAL_UART_ISR == 1))
 #define HAL_UART_PRIPO             0x00
@@ -488,6 +528,23 @@ st( \
 #else
 #define HAL_UART_DMA  0
 #define HAL_UART_ISR  0
+#define HAL_UART_DMA_EVT  FALSE
+#endif
+
+/* Set to TRUE to account time per power mode, wake causes and sleep vetoes, FALSE disable it */
+#ifndef HAL_SLEEP_STATS
+#define HAL_SLEEP_STATS FALSE
+#endif
+#if (HAL_SLEEP_STATS == TRUE) && !(defined POWER_SAVING)
+#error HAL_SLEEP_STATS requires POWER_SAVING.
+#endif
+
+/* Set to TRUE to stream promiscuously received frames over the UART, FALSE disable it */
+#ifndef HAL_SNIFFER
+#define HAL_SNIFFER FALSE
+#endif
+#if (HAL_SNIFFER == TRUE) && (HAL_UART != TRUE)
+#error HAL_SNIFFER requires HAL_UART.
 #endif
 
 /* USB is not used for CC2530 configuration */
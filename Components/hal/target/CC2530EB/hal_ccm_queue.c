@@ -0,0 +1,541 @@
+/**************************************************************************************************
+  Filename:       hal_ccm_queue.c
+
+  Description:    Queued CCM* jobs on the hardware AES, fed by DMA.
+
+
+  Added to this Z-Stack tree in 2026; not part of the Texas Instruments release. It only
+  builds into the Z-Stack and is distributed under the same license as the Texas Instruments
+  sources it is built with, as stated in their file headers (e.g. hal_dma.c).
+**************************************************************************************************/
+
+/***************************************************************************************************
+ *                                             INCLUDES
+ ***************************************************************************************************/
+#include "ZComDef.h"
+#include "OSAL.h"
+#include "hal_mcu.h"
+#include "hal_dma.h"
+#include "hal_aes.h"
+#include "hal_ccm.h"
+#include "hal_drivers.h"
+
+#if (defined HAL_CCM_QUEUE) && (HAL_CCM_QUEUE == TRUE)
+
+/***************************************************************************************************
+ *                                             CONSTANTS
+ ***************************************************************************************************/
+/* Room for B0 and the length prefixed aData and mData, each padded to whole blocks. Larger jobs
+ * run through the one-shot SSP_CCM_xxx calls instead.
+ */
+#ifndef HAL_CCM_BUF_SIZE
+#define HAL_CCM_BUF_SIZE        128
+#endif
+
+#define HAL_CCM_NONCE_LEN       13
+#define HAL_CCM_L               2       /* Bytes in the length and counter fields */
+#define HAL_CCM_FLAG_ADATA      0x40    /* B0 flag for a non-empty aData */
+#define HAL_CCM_ALEN_MAX        0xFEFF  /* Longest aData with a 2 byte length prefix */
+
+/* State of the known answer check that gates the DMA path, see HalCcmSelfTest() */
+#define HAL_CCM_CHECK_NONE      0
+#define HAL_CCM_CHECK_PASS      1
+#define HAL_CCM_CHECK_FAIL      2
+
+/* RFC 3610 packet vector #1: M = 8, L = 2, 8 bytes of aData and 23 of mData */
+#define HAL_CCM_KAT_MVAL        8
+#define HAL_CCM_KAT_ALEN        8
+#define HAL_CCM_KAT_MLEN        23
+
+/***************************************************************************************************
+ *                                              MACROS
+ ***************************************************************************************************/
+#define HAL_CCM_BLOCKS(len)     (((len) + (STATE_BLENGTH - 1)) & ~(STATE_BLENGTH - 1))
+
+/***************************************************************************************************
+ *                                           LOCAL VARIABLES
+ ***************************************************************************************************/
+static halCcmJob_t *halCcmHead;
+static halCcmJob_t *halCcmTail;
+
+/* Key in the AES core, only trusted within one batch since the stack loads its own */
+static uint8 halCcmKey[KEY_BLENGTH];
+static bool halCcmKeyLoaded;
+
+static uint8 halCcmBuf[HAL_CCM_BUF_SIZE];
+
+static uint8 halCcmCheck = HAL_CCM_CHECK_NONE;
+
+static CONST uint8 halCcmKatKey[KEY_BLENGTH] = {
+  0xC0, 0xC1, 0xC2, 0xC3, 0xC4, 0xC5, 0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xCB, 0xCC, 0xCD, 0xCE, 0xCF
+};
+static CONST uint8 halCcmKatNonce[HAL_CCM_NONCE_LEN] = {
+  0x00, 0x00, 0x00, 0x03, 0x02, 0x01, 0x00, 0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5
+};
+/* The packet is 0x00 .. 0x1E: the aData and then the plain mData count up from 0 */
+static CONST uint8 halCcmKatCipher[HAL_CCM_KAT_MLEN] = {
+  0x58, 0x8C, 0x97, 0x9A, 0x61, 0xC6, 0x63, 0xD2, 0xF0, 0x66, 0xD0, 0xC2,
+  0xC0, 0xF9, 0x89, 0x80, 0x6D, 0x5F, 0x6B, 0x61, 0xDA, 0xC3, 0x84
+};
+static CONST uint8 halCcmKatMic[HAL_CCM_KAT_MVAL] = {
+  0x17, 0xE8, 0xD1, 0x2C, 0xFD, 0xF9, 0x26, 0xE0
+};
+
+/***************************************************************************************************
+ *                                            FUNCTIONS - Local
+ ***************************************************************************************************/
+static void halCcmHw ( halCcmJob_t *job );
+static uint16 halCcmAuthLen ( halCcmJob_t *job );
+static void halCcmAuth ( halCcmJob_t *job, uint8 *tag );
+static void halCcmCtr ( halCcmJob_t *job, uint8 *mic );
+static void halCcmRun ( uint8 mode, uint8 *iv, uint16 len );
+static void halCcmOneShot ( halCcmJob_t *job );
+
+/***************************************************************************************************
+ *                                            FUNCTIONS - API
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * @fn      HalCcmSubmit
+ *
+ * @brief   Queue a CCM* job for the Hal task. The job and the buffers it points to must stay put
+ *          until its callback.
+ *
+ * @param   job - the job, with everything but next and status filled in
+ *
+ * @return  SUCCESS if queued, INVALIDPARAMETER if not
+ ***************************************************************************************************/
+uint8 HalCcmSubmit (halCcmJob_t *job)
+{
+  halIntState_t his;
+
+  if ((job == NULL) || (job->key == NULL) || (job->nonce == NULL) ||
+      ((job->Mval != 0) && (job->Mval != 4) && (job->Mval != 8) && (job->Mval != 16)) ||
+      ((job->Mval != 0) && (job->mic == NULL)) || (job->aLen > HAL_CCM_ALEN_MAX) ||
+      ((job->op != HAL_CCM_ENCRYPT) && (job->op != HAL_CCM_DECRYPT)))
+  {
+    return INVALIDPARAMETER;
+  }
+
+  job->next = NULL;
+
+  HAL_ENTER_CRITICAL_SECTION(his);
+  if (halCcmTail != NULL)
+  {
+    halCcmTail->next = job;
+  }
+  else
+  {
+    halCcmHead = job;
+  }
+  halCcmTail = job;
+  HAL_EXIT_CRITICAL_SECTION(his);
+
+  osal_set_event(Hal_TaskID, HAL_CCM_EVENT);
+
+  return SUCCESS;
+}
+
+/***************************************************************************************************
+ * @fn      HalCcmProcess
+ *
+ * @brief   Run the queued jobs back to back, loading the key only when it changes, then make the
+ *          callbacks. Callbacks come after the whole batch because they may well send the data,
+ *          and the stack security then loads keys of its own. Jobs queued by a callback make
+ *          the next batch. The first batch runs HalCcmSelfTest() and, should it fail, every job
+ *          from then on goes through the one-shot calls of the security library.
+ *
+ * @param   None
+ *
+ * @return  None
+ ***************************************************************************************************/
+void HalCcmProcess (void)
+{
+  halIntState_t his;
+  halCcmJob_t *job;
+  halCcmJob_t *done = NULL;
+  halCcmJob_t *doneTail = NULL;
+
+  if (halCcmCheck == HAL_CCM_CHECK_NONE)
+  {
+    (void)HalCcmSelfTest();
+  }
+
+  halCcmKeyLoaded = FALSE;
+
+  while (1)
+  {
+    HAL_ENTER_CRITICAL_SECTION(his);
+    job = halCcmHead;
+    if (job != NULL)
+    {
+      halCcmHead = job->next;
+      if (halCcmHead == NULL)
+      {
+        halCcmTail = NULL;
+      }
+    }
+    HAL_EXIT_CRITICAL_SECTION(his);
+
+    if (job == NULL)
+    {
+      break;
+    }
+
+    if ((halCcmCheck != HAL_CCM_CHECK_PASS) || (halCcmAuthLen(job) > HAL_CCM_BUF_SIZE) ||
+        ((STATE_BLENGTH + HAL_CCM_BLOCKS(job->mLen)) > HAL_CCM_BUF_SIZE))
+    {
+      halCcmOneShot(job);
+    }
+    else
+    {
+      halCcmHw(job);
+    }
+
+    job->next = NULL;
+    if (doneTail != NULL)
+    {
+      doneTail->next = job;
+    }
+    else
+    {
+      done = job;
+    }
+    doneTail = job;
+  }
+
+  while (done != NULL)
+  {
+    job = done;
+    done = job->next;
+
+    if (job->cBack != NULL)
+    {
+      job->cBack(job);
+    }
+  }
+}
+
+/***************************************************************************************************
+ * @fn      HalCcmSelfTest
+ *
+ * @brief   Known answer check of the DMA path on this chip against RFC 3610 packet vector #1:
+ *          encrypt it, decrypt it back, reject it with a MIC bit flipped, and encrypt it again
+ *          through the one-shot calls that jobs fall back to. The result gates the DMA path in
+ *          HalCcmProcess(). Must be called from the Hal task, as it uses the AES.
+ *
+ * @param   None
+ *
+ * @return  SUCCESS if every answer matched, FAILURE if not
+ ***************************************************************************************************/
+uint8 HalCcmSelfTest (void)
+{
+  halCcmJob_t job;
+  uint8 key[KEY_BLENGTH];
+  uint8 nonce[HAL_CCM_NONCE_LEN];
+  uint8 aData[HAL_CCM_KAT_ALEN];
+  uint8 mData[HAL_CCM_KAT_MLEN];
+  uint8 mic[HAL_CCM_KAT_MVAL];
+  uint8 idx;
+  bool pass = TRUE;
+
+  osal_memcpy(key, halCcmKatKey, KEY_BLENGTH);
+  osal_memcpy(nonce, halCcmKatNonce, HAL_CCM_NONCE_LEN);
+  for (idx = 0; idx < HAL_CCM_KAT_ALEN; idx++)
+  {
+    aData[idx] = idx;
+  }
+
+  job.Mval = HAL_CCM_KAT_MVAL;
+  job.key = key;
+  job.nonce = nonce;
+  job.aData = aData;
+  job.aLen = HAL_CCM_KAT_ALEN;
+  job.mData = mData;
+  job.mLen = HAL_CCM_KAT_MLEN;
+  job.mic = mic;
+  job.cBack = NULL;
+
+  halCcmKeyLoaded = FALSE;
+
+  for (idx = 0; idx < 4; idx++)
+  {
+    if ((idx == 0) || (idx == 3))
+    {
+      /* Encrypt the plain packet, by DMA and then one-shot */
+      uint8 cnt;
+
+      for (cnt = 0; cnt < HAL_CCM_KAT_MLEN; cnt++)
+      {
+        mData[cnt] = HAL_CCM_KAT_ALEN + cnt;
+      }
+      job.op = HAL_CCM_ENCRYPT;
+    }
+    else
+    {
+      /* Decrypt the expected answer, the 2nd time with a MIC bit flipped */
+      osal_memcpy(mData, halCcmKatCipher, HAL_CCM_KAT_MLEN);
+      osal_memcpy(mic, halCcmKatMic, HAL_CCM_KAT_MVAL);
+      if (idx == 2)
+      {
+        mic[HAL_CCM_KAT_MVAL - 1] ^= 0x01;
+      }
+      job.op = HAL_CCM_DECRYPT;
+    }
+
+    if (idx == 3)
+    {
+      halCcmOneShot(&job);
+    }
+    else
+    {
+      halCcmHw(&job);
+    }
+
+    if (job.op == HAL_CCM_ENCRYPT)
+    {
+      if (!osal_memcmp(mData, halCcmKatCipher, HAL_CCM_KAT_MLEN) ||
+          !osal_memcmp(mic, halCcmKatMic, HAL_CCM_KAT_MVAL))
+      {
+        pass = FALSE;
+      }
+    }
+    else if (job.status != ((idx == 2) ? FAILURE : SUCCESS))
+    {
+      pass = FALSE;
+    }
+    else if (idx == 1)
+    {
+      uint8 cnt;
+
+      for (cnt = 0; cnt < HAL_CCM_KAT_MLEN; cnt++)
+      {
+        if (mData[cnt] != (HAL_CCM_KAT_ALEN + cnt))
+        {
+          pass = FALSE;
+        }
+      }
+    }
+  }
+
+  /* The stack loads its own key before it next uses the AES */
+  halCcmKeyLoaded = FALSE;
+  halCcmCheck = (pass) ? HAL_CCM_CHECK_PASS : HAL_CCM_CHECK_FAIL;
+
+  return (pass) ? SUCCESS : FAILURE;
+}
+
+/***************************************************************************************************
+ *                                            FUNCTIONS - Local
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * @fn      halCcmHw
+ *
+ * @brief   Run a job that fits halCcmBuf on the AES fed by DMA, loading the key if it changed
+ *
+ * @param   job - the job
+ *
+ * @return  None
+ ***************************************************************************************************/
+static void halCcmHw (halCcmJob_t *job)
+{
+  uint8 tag[STATE_BLENGTH];
+  uint8 mic[STATE_BLENGTH];
+
+  if (!halCcmKeyLoaded || !osal_memcmp(halCcmKey, job->key, KEY_BLENGTH))
+  {
+    osal_memcpy(halCcmKey, job->key, KEY_BLENGTH);
+    AesLoadKey(halCcmKey);
+    halCcmKeyLoaded = TRUE;
+  }
+
+  job->status = SUCCESS;
+
+  if (job->op == HAL_CCM_ENCRYPT)
+  {
+    halCcmAuth(job, tag);
+    halCcmCtr(job, tag);
+    osal_memcpy(job->mic, tag, job->Mval);
+  }
+  else
+  {
+    osal_memcpy(mic, job->mic, job->Mval);
+    halCcmCtr(job, mic);
+
+    if (job->Mval != 0)
+    {
+      halCcmAuth(job, tag);
+      if (!osal_memcmp(tag, mic, job->Mval))
+      {
+        job->status = FAILURE;
+      }
+    }
+  }
+}
+
+/***************************************************************************************************
+ * @fn      halCcmAuthLen
+ *
+ * @brief   Bytes of the formatted input to the CBC-MAC
+ *
+ * @param   job - the job
+ *
+ * @return  length, a whole number of blocks
+ ***************************************************************************************************/
+static uint16 halCcmAuthLen (halCcmJob_t *job)
+{
+  uint16 len = STATE_BLENGTH + HAL_CCM_BLOCKS(job->mLen);
+
+  if (job->aLen != 0)
+  {
+    len += HAL_CCM_BLOCKS(job->aLen + HAL_CCM_L);
+  }
+
+  return len;
+}
+
+/***************************************************************************************************
+ * @fn      halCcmAuth
+ *
+ * @brief   CBC-MAC over B0, aData and mData. The AES has no CBC-MAC output by DMA, so the blocks
+ *          run in CBC mode, in place, and the tag is the last one.
+ *
+ * @param   job - the job
+ *          tag - STATE_BLENGTH bytes for the tag
+ *
+ * @return  None
+ ***************************************************************************************************/
+static void halCcmAuth (halCcmJob_t *job, uint8 *tag)
+{
+  uint8 *p = halCcmBuf;
+  uint16 len;
+
+  /* B0: flags, nonce and the mData length */
+  p[0] = (HAL_CCM_L - 1);
+  if (job->aLen != 0)
+  {
+    p[0] |= HAL_CCM_FLAG_ADATA;
+  }
+  if (job->Mval != 0)
+  {
+    p[0] |= ((job->Mval - 2) / 2) << 3;
+  }
+  osal_memcpy(p + 1, job->nonce, HAL_CCM_NONCE_LEN);
+  p[14] = HI_UINT16(job->mLen);
+  p[15] = LO_UINT16(job->mLen);
+  p += STATE_BLENGTH;
+
+  if (job->aLen != 0)
+  {
+    len = job->aLen + HAL_CCM_L;
+    p[0] = HI_UINT16(job->aLen);
+    p[1] = LO_UINT16(job->aLen);
+    osal_memcpy(p + HAL_CCM_L, job->aData, job->aLen);
+    osal_memset(p + len, 0, HAL_CCM_BLOCKS(len) - len);
+    p += HAL_CCM_BLOCKS(len);
+  }
+
+  osal_memcpy(p, job->mData, job->mLen);
+  osal_memset(p + job->mLen, 0, HAL_CCM_BLOCKS(job->mLen) - job->mLen);
+  p += HAL_CCM_BLOCKS(job->mLen);
+
+  osal_memset(tag, 0, STATE_BLENGTH);
+  halCcmRun(CBC, tag, (uint16)(p - halCcmBuf));
+  osal_memcpy(tag, p - STATE_BLENGTH, STATE_BLENGTH);
+}
+
+/***************************************************************************************************
+ * @fn      halCcmCtr
+ *
+ * @brief   En/decrypt the MIC with counter 0 and mData with the counters after it, all in one
+ *          CTR run.
+ *
+ * @param   job - the job
+ *          mic - STATE_BLENGTH bytes holding the MIC in its first Mval, en/decrypted in place
+ *
+ * @return  None
+ ***************************************************************************************************/
+static void halCcmCtr (halCcmJob_t *job, uint8 *mic)
+{
+  uint8 a0[STATE_BLENGTH];
+
+  osal_memcpy(halCcmBuf, mic, STATE_BLENGTH);
+  osal_memcpy(halCcmBuf + STATE_BLENGTH, job->mData, job->mLen);
+  osal_memset(halCcmBuf + STATE_BLENGTH + job->mLen, 0,
+              HAL_CCM_BLOCKS(job->mLen) - job->mLen);
+
+  a0[0] = (HAL_CCM_L - 1);
+  osal_memcpy(a0 + 1, job->nonce, HAL_CCM_NONCE_LEN);
+  a0[14] = 0;
+  a0[15] = 0;
+
+  halCcmRun(CTR, a0, STATE_BLENGTH + HAL_CCM_BLOCKS(job->mLen));
+
+  osal_memcpy(mic, halCcmBuf, job->Mval);
+  osal_memcpy(job->mData, halCcmBuf + STATE_BLENGTH, job->mLen);
+}
+
+/***************************************************************************************************
+ * @fn      halCcmRun
+ *
+ * @brief   Run halCcmBuf through the AES in place, the blocks fed in and out by the AES channels
+ *          set up in HalAesInit(), and wait for the last block out.
+ *
+ * @param   mode - CBC or CTR
+ *          iv - STATE_BLENGTH bytes of IV or initial counter
+ *          len - bytes, a whole number of blocks
+ *
+ * @return  None
+ ***************************************************************************************************/
+static void halCcmRun (uint8 mode, uint8 *iv, uint16 len)
+{
+  AES_SETMODE(mode);
+  AesLoadIV(iv);
+
+  AesDmaSetup(halCcmBuf, len, halCcmBuf, len);
+  AES_SET_ENCR_DECR_KEY_IV(AES_ENCRYPT);
+  AES_START();
+
+  while (!HAL_DMA_CHECK_IRQ(HAL_DMA_AES_OUT));
+  HAL_DMA_CLEAR_IRQ(HAL_DMA_AES_IN);
+  HAL_DMA_CLEAR_IRQ(HAL_DMA_AES_OUT);
+}
+
+/***************************************************************************************************
+ * @fn      halCcmOneShot
+ *
+ * @brief   Run a job too big for halCcmBuf through the one-shot calls of the security library
+ *
+ * @param   job - the job
+ *
+ * @return  None
+ ***************************************************************************************************/
+static void halCcmOneShot (halCcmJob_t *job)
+{
+  uint8 cState[STATE_BLENGTH];
+
+  if (job->op == HAL_CCM_ENCRYPT)
+  {
+    SSP_CCM_Auth(job->Mval, job->nonce, job->mData, job->mLen, job->aData, job->aLen,
+                 job->key, cState);
+    SSP_CCM_Encrypt(job->Mval, job->nonce, job->mData, job->mLen, job->key, cState);
+    osal_memcpy(job->mic, cState, job->Mval);
+    job->status = SUCCESS;
+  }
+  else
+  {
+    osal_memcpy(cState, job->mic, job->Mval);
+    SSP_CCM_Decrypt(job->Mval, job->nonce, job->mData, job->mLen, job->key, cState);
+    job->status = (SSP_CCM_InvAuth(job->Mval, job->nonce, job->mData, job->mLen, job->aData,
+                                   job->aLen, job->key, cState) == 0) ? SUCCESS : FAILURE;
+  }
+
+  /* The library loads the key itself */
+  halCcmKeyLoaded = FALSE;
+}
+
+#endif /* HAL_CCM_QUEUE */
+
+/***************************************************************************************************
+***************************************************************************************************/
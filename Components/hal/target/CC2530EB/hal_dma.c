@@ -55,6 +55,10 @@
 #include "hal_spi.h"
 #endif
 
+#if (defined HAL_AES_DMA) && (HAL_AES_DMA == TRUE)
+#include "hal_aes.h"
+#endif
+
 
 #if ((defined HAL_DMA) && (HAL_DMA == TRUE))
 
@@ -81,14 +85,28 @@ halDMADesc_t dmaCh1234[4];
  * GLOBAL FUNCTIONS
  */
 
+#if HAL_UART_DMA
+extern void HalUARTIsrDMA(void);
+#endif
+
 /*********************************************************************
  * LOCAL VARIABLES
  */
 
+static uint8 dmaChUsed;                           // Bit per channel allocated or reserved.
+static halDmaCBack_t dmaChCBack[HAL_DMA_CH_CNT];  // Completion callbacks by channel.
+static uint8 dmaFill;                             // XDATA source of HalDmaMemset().
+static volatile bool dmaFillBusy;
+
 /*********************************************************************
  * LOCAL FUNCTIONS
  */
 
+#if HAL_UART_DMA
+static void dmaUartTxCB( uint8 ch );
+#endif
+static bool dmaMemXfer( void *dst, const void *src, uint16 len, uint8 srcInc );
+
 /******************************************************************************
  * @fn      HalDMAInit
  *
@@ -102,18 +120,257 @@ void HalDmaInit( void )
 {
   HAL_DMA_SET_ADDR_DESC0( &dmaCh0 );
   HAL_DMA_SET_ADDR_DESC1234( dmaCh1234 );
-#if (HAL_UART_DMA || \
-   ((defined HAL_SPI) && (HAL_SPI == TRUE))  || \
-   ((defined HAL_IRGEN) && (HAL_IRGEN == TRUE)))
-  DMAIE = 1;
+
+  HalDmaReserve( HAL_NV_DMA_CH, NULL );
+#if HAL_UART_DMA
+  HalDmaReserve( HAL_DMA_CH_RX, NULL );
+  HalDmaReserve( HAL_DMA_CH_TX, dmaUartTxCB );
+#endif
+#if (defined HAL_SPI) && (HAL_SPI == TRUE)
+  HalDmaReserve( HAL_DMA_CH_RX, NULL );
+  HalDmaReserve( HAL_DMA_CH_TX, NULL );
+#endif
+#if (defined HAL_IRGEN) && (HAL_IRGEN == TRUE)
+  HalDmaReserve( HAL_IRGEN_DMA_CH, NULL );
+#endif
+#if (defined HAL_AES_DMA) && (HAL_AES_DMA == TRUE)
+  // HalAesInit() sets these descriptors up once and AesDmaSetup() only changes the buffers.
+  HalDmaReserve( HAL_DMA_AES_IN, NULL );
+  HalDmaReserve( HAL_DMA_AES_OUT, NULL );
 #endif
+
+  // Channels are handed out at run time, so the ISR is always enabled.
+  DMAIE = 1;
 }
 
-#if (HAL_UART_DMA || \
-   ((defined HAL_SPI) && (HAL_SPI == TRUE))  || \
-   ((defined HAL_IRGEN) && (HAL_IRGEN == TRUE)))
 /******************************************************************************
- * @fn      HalDMAInit
+ * @fn      HalDmaAlloc
+ *
+ * @brief   Allocate consecutive DMA channels from 1-4. When channels have the same
+ *          descriptor priority, the lower channel number wins arbitration, so high
+ *          priority users are given the lowest free channels and others the highest.
+ *
+ * @param   cnt - Number of channels, more than 1 to chain descriptors by
+ *                HAL_DMA_TRIG_PREV.
+ * @param   pri - HAL_DMA_PRI_xxx the descriptors are to be set up with.
+ * @param   cBack - Completion callback for each channel, or NULL.
+ *
+ * @return  First channel allocated, or HAL_DMA_CH_NONE.
+ *****************************************************************************/
+uint8 HalDmaAlloc( uint8 cnt, uint8 pri, halDmaCBack_t cBack )
+{
+  halIntState_t his;
+  uint8 mask, ch, first = HAL_DMA_CH_NONE;
+
+  // The NV reservation also marks that HalDmaInit() has set up the descriptor addresses.
+  if ((cnt == 0) || (cnt >= HAL_DMA_CH_CNT) || !(dmaChUsed & (1 << HAL_NV_DMA_CH)))
+  {
+    return HAL_DMA_CH_NONE;
+  }
+  mask = (uint8)((1 << cnt) - 1);
+
+  HAL_ENTER_CRITICAL_SECTION(his);
+
+  for (ch = 1; (ch + cnt) <= HAL_DMA_CH_CNT; ch++)
+  {
+    if (!(dmaChUsed & (mask << ch)))
+    {
+      first = ch;
+      if (pri >= HAL_DMA_PRI_HIGH)
+      {
+        break;
+      }
+    }
+  }
+
+  if (first != HAL_DMA_CH_NONE)
+  {
+    dmaChUsed |= (mask << first);
+    for (ch = first; ch < (first + cnt); ch++)
+    {
+      dmaChCBack[ch] = cBack;
+    }
+  }
+
+  HAL_EXIT_CRITICAL_SECTION(his);
+
+  return first;
+}
+
+/******************************************************************************
+ * @fn      HalDmaFree
+ *
+ * @brief   Abort and release channels from HalDmaAlloc().
+ *
+ * @param   ch - First channel.
+ * @param   cnt - Number of channels.
+ *
+ * @return  None
+ *****************************************************************************/
+void HalDmaFree( uint8 ch, uint8 cnt )
+{
+  halIntState_t his;
+
+  HAL_ENTER_CRITICAL_SECTION(his);
+
+  while (cnt-- && (ch < HAL_DMA_CH_CNT))
+  {
+    HAL_DMA_ABORT_CH( ch );
+    HAL_DMA_CLEAR_IRQ( ch );
+    dmaChCBack[ch] = NULL;
+    dmaChUsed &= ~(1 << ch);
+    ch++;
+  }
+
+  HAL_EXIT_CRITICAL_SECTION(his);
+}
+
+/******************************************************************************
+ * @fn      HalDmaReserve
+ *
+ * @brief   Claim a fixed channel for a driver that is built around it.
+ *
+ * @param   ch - Channel.
+ * @param   cBack - Completion callback, or NULL if the driver polls.
+ *
+ * @return  None
+ *****************************************************************************/
+void HalDmaReserve( uint8 ch, halDmaCBack_t cBack )
+{
+  halIntState_t his;
+
+  HAL_ENTER_CRITICAL_SECTION(his);
+  dmaChUsed |= (1 << ch);
+  dmaChCBack[ch] = cBack;
+  HAL_EXIT_CRITICAL_SECTION(his);
+}
+
+/******************************************************************************
+ * @fn      HalDmaMemcpy
+ *
+ * @brief   Copy XDATA memory by DMA.
+ *
+ * @param   dst - Destination address.
+ * @param   src - Source address.
+ * @param   len - Number of bytes, up to HAL_DMA_LEN_MAX.
+ *
+ * @return  TRUE if copied, FALSE if the caller must copy.
+ *****************************************************************************/
+bool HalDmaMemcpy( void *dst, const void *src, uint16 len )
+{
+  return dmaMemXfer( dst, src, len, HAL_DMA_SRCINC_1 );
+}
+
+/******************************************************************************
+ * @fn      HalDmaMemset
+ *
+ * @brief   Set XDATA memory by DMA.
+ *
+ * @param   dst - Destination address.
+ * @param   value - Byte to set.
+ * @param   len - Number of bytes, up to HAL_DMA_LEN_MAX.
+ *
+ * @return  TRUE if set, FALSE if the caller must set.
+ *****************************************************************************/
+bool HalDmaMemset( void *dst, uint8 value, uint16 len )
+{
+  halIntState_t his;
+  bool rtrn;
+
+  // The source byte is shared, so a call nested from an ISR leaves the set to the caller.
+  HAL_ENTER_CRITICAL_SECTION(his);
+  if (dmaFillBusy)
+  {
+    HAL_EXIT_CRITICAL_SECTION(his);
+    return FALSE;
+  }
+  dmaFillBusy = TRUE;
+  HAL_EXIT_CRITICAL_SECTION(his);
+
+  dmaFill = value;
+  rtrn = dmaMemXfer( dst, &dmaFill, len, HAL_DMA_SRCINC_0 );
+  dmaFillBusy = FALSE;
+
+  return rtrn;
+}
+
+/******************************************************************************
+ * @fn      dmaMemXfer
+ *
+ * @brief   Run a manually triggered block transfer on a low priority channel and
+ *          wait for the channel to disarm itself at the end of the block. The
+ *          CPU only polls an SFR meanwhile, so the transfer is not held off.
+ *
+ * @param   dst - Destination address.
+ * @param   src - Source address.
+ * @param   len - Number of bytes.
+ * @param   srcInc - HAL_DMA_SRCINC_1 to copy, HAL_DMA_SRCINC_0 to fill.
+ *
+ * @return  TRUE if transferred, FALSE if no channel was free or len is too big.
+ *****************************************************************************/
+static bool dmaMemXfer( void *dst, const void *src, uint16 len, uint8 srcInc )
+{
+  halDMADesc_t *pDesc;
+  uint8 ch;
+
+  if ((len == 0) || (len > HAL_DMA_LEN_MAX))
+  {
+    return FALSE;
+  }
+
+  ch = HalDmaAlloc( 1, HAL_DMA_PRI_LOW, NULL );
+  if (ch == HAL_DMA_CH_NONE)
+  {
+    return FALSE;
+  }
+
+  pDesc = HAL_DMA_GET_DESC1234( ch );
+  HAL_DMA_SET_SOURCE( pDesc, src );
+  HAL_DMA_SET_DEST( pDesc, dst );
+  HAL_DMA_SET_VLEN( pDesc, HAL_DMA_VLEN_USE_LEN );
+  HAL_DMA_SET_LEN( pDesc, len );
+  HAL_DMA_SET_WORD_SIZE( pDesc, HAL_DMA_WORDSIZE_BYTE );
+  HAL_DMA_SET_TRIG_MODE( pDesc, HAL_DMA_TMODE_BLOCK );
+  HAL_DMA_SET_TRIG_SRC( pDesc, HAL_DMA_TRIG_NONE );
+  HAL_DMA_SET_SRC_INC( pDesc, srcInc );
+  HAL_DMA_SET_DST_INC( pDesc, HAL_DMA_DSTINC_1 );
+  HAL_DMA_SET_IRQ( pDesc, HAL_DMA_IRQMASK_DISABLE );
+  HAL_DMA_SET_M8( pDesc, HAL_DMA_M8_USE_8_BITS );
+  HAL_DMA_SET_PRIORITY( pDesc, HAL_DMA_PRI_LOW );
+
+  HAL_DMA_ARM_CH( ch );
+  do
+  {
+    asm("NOP");
+  } while (!HAL_DMA_CH_ARMED( ch ));
+  HAL_DMA_MAN_TRIGGER( ch );
+
+  while (HAL_DMA_CH_ARMED( ch ));
+
+  HalDmaFree( ch, 1 );
+
+  return TRUE;
+}
+
+#if HAL_UART_DMA
+/******************************************************************************
+ * @fn      dmaUartTxCB
+ *
+ * @brief   Pass the UART Tx channel done to the DMA UART driver.
+ *
+ * @param   ch - HAL_DMA_CH_TX
+ *
+ * @return  None
+ *****************************************************************************/
+static void dmaUartTxCB( uint8 ch )
+{
+  (void)ch;
+  HalUARTIsrDMA();
+}
+#endif
+
+/******************************************************************************
+ * @fn      halDmaIsr
  *
  * @brief   DMA Interrupt Service Routine
  *
@@ -123,18 +380,20 @@ void HalDmaInit( void )
  *****************************************************************************/
 HAL_ISR_FUNCTION( halDmaIsr, DMA_VECTOR )
 {
-  extern void HalUARTIsrDMA(void);
+  uint8 ch;
 
   HAL_ENTER_ISR();
 
   DMAIF = 0;
 
-#if HAL_UART_DMA
-  if (HAL_DMA_CHECK_IRQ(HAL_DMA_CH_TX))
+  for (ch = 0; ch < HAL_DMA_CH_CNT; ch++)
   {
-    HalUARTIsrDMA();
+    if ((dmaChCBack[ch] != NULL) && HAL_DMA_CHECK_IRQ(ch))
+    {
+      HAL_DMA_CLEAR_IRQ(ch);
+      dmaChCBack[ch](ch);
+    }
   }
-#endif // HAL_UART_DMA
 
 #if (defined HAL_SPI) && (HAL_SPI == TRUE)
   if ( HAL_DMA_CHECK_IRQ( HAL_DMA_CH_RX ) )
@@ -161,7 +420,6 @@ HAL_ISR_FUNCTION( halDmaIsr, DMA_VECTOR )
   CLEAR_SLEEP_MODE();
   HAL_EXIT_ISR();
 }
-#endif
 #endif  // #if ((defined HAL_DMA) && (HAL_DMA == TRUE))
 /******************************************************************************
 ******************************************************************************/
@@ -246,6 +246,20 @@ extern "C"
 
 #define HAL_DMA_MAX_ARM_CLOCKS   45   // Maximum number of clocks required if arming all 5 at once.
 
+#define HAL_DMA_CH_CNT           5    /* Channel 0 with its own descriptor, 1-4 from dmaCh1234. */
+#define HAL_DMA_CH_NONE          0xFF /* HalDmaAlloc() found no free channel. */
+
+/* HalDmaInit() reserves channel 0 for NV, 1/2 for the AES driver (HAL_AES_DMA) and 3/4 for the
+ * DMA UART or SPI. With AES and a DMA UART or SPI built in, as in every MT/ZTOOL build, nothing
+ * is left for HalDmaAlloc(): its users are then compiled without their DMA path, or refused. */
+#if (defined HAL_AES_DMA) && (HAL_AES_DMA == TRUE) && \
+    (HAL_UART_DMA || ((defined HAL_SPI) && (HAL_SPI == TRUE)))
+#define HAL_DMA_ALLOC_FREE       FALSE
+#else
+#define HAL_DMA_ALLOC_FREE       TRUE
+#endif
+#define HAL_DMA_LEN_MAX          0x1FFF
+
 /*********************************************************************
  * TYPEDEFS
  */
@@ -277,6 +291,9 @@ typedef struct {
   uint8 ctrlB;
 } halDMADesc_t;
 
+/* Called from halDmaIsr with the channel IRQ flag already cleared. */
+typedef void (*halDmaCBack_t)( uint8 ch );
+
 /*********************************************************************
  * GLOBAL VARIABLES
  */
@@ -290,6 +307,32 @@ extern halDMADesc_t dmaCh1234[4];
 
 void HalDmaInit( void );
 
+/*
+ * Allocate 'cnt' consecutive channels from 1-4, so that the later ones can be chained to the
+ * first by HAL_DMA_TRIG_PREV. High priority users get the lowest free channels, which win
+ * arbitration against equal descriptor priorities; others get the highest.
+ * Returns the first channel or HAL_DMA_CH_NONE.
+ */
+uint8 HalDmaAlloc( uint8 cnt, uint8 pri, halDmaCBack_t cBack );
+
+/*
+ * Abort and release channels from HalDmaAlloc().
+ */
+void HalDmaFree( uint8 ch, uint8 cnt );
+
+/*
+ * Claim a channel at a fixed number for a driver that is built around it.
+ */
+void HalDmaReserve( uint8 ch, halDmaCBack_t cBack );
+
+/*
+ * Copy/set XDATA memory by a block transfer on a free channel and wait for it.
+ * Return FALSE, with nothing done, if no channel is free or 'len' is above HAL_DMA_LEN_MAX.
+ * Always FALSE without HAL_DMA_ALLOC_FREE.
+ */
+bool HalDmaMemcpy( void *dst, const void *src, uint16 len );
+bool HalDmaMemset( void *dst, uint8 value, uint16 len );
+
 #endif  // #if (defined HAL_DMA) && (HAL_DMA == TRUE)
 
 #ifdef __cplusplus
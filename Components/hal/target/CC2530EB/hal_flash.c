@@ -48,6 +48,54 @@
 #include "hal_mcu.h"
 #include "hal_types.h"
 
+/* ------------------------------------------------------------------------------------------------
+ *                                          Constants
+ * ------------------------------------------------------------------------------------------------
+ */
+
+#define HAL_FLASH_FCTL_ERASE       0x01
+#define HAL_FLASH_FCTL_WRITE       0x02
+#define HAL_FLASH_FCTL_BUSY        0x80
+
+#if HAL_FLASH_ASYNC
+#if !defined HAL_FLASH_Q_MAX
+#define HAL_FLASH_Q_MAX            4
+#endif
+
+/* ------------------------------------------------------------------------------------------------
+ *                                          Typedefs
+ * ------------------------------------------------------------------------------------------------
+ */
+
+typedef struct
+{
+  uint8 *buf;              // NULL for an erase.
+  uint16 addr;             // Flash write address or page to erase.
+  uint16 cnt;
+  halFlashCBack_t cBack;
+} halFlashReq_t;
+
+/* ------------------------------------------------------------------------------------------------
+ *                                       Local Variables
+ * ------------------------------------------------------------------------------------------------
+ */
+
+static halFlashReq_t halFlashQ[HAL_FLASH_Q_MAX];
+static uint8 halFlashQHead;
+static uint8 halFlashQCnt;
+static bool halFlashActive;  // The request at the head of the queue has been started.
+
+/* ------------------------------------------------------------------------------------------------
+ *                                       Local Functions
+ * ------------------------------------------------------------------------------------------------
+ */
+
+static void halFlashQueue(uint8 *buf, uint16 addr, uint16 cnt, halFlashCBack_t cBack);
+static void halFlashService(bool wait);
+#endif
+
+static void halFlashWriteStart(uint16 addr, uint8 *buf, uint16 cnt);
+
 /**************************************************************************************************
  * @fn          HalFlashRead
  *
@@ -78,6 +126,10 @@ void HalFlashRead(uint8 pg, uint16 offset, uint8 *buf, uint16 cnt)
   halIntState_t is;
 #endif
 
+#if HAL_FLASH_ASYNC
+  HalFlashFlush();  // Read back what has been queued.
+#endif
+
   pg /= HAL_FLASH_PAGE_PER_BANK;  // Calculate the flash bank from the flash page.
 
 #if (!defined HAL_OAD_BOOT_CODE) && (!defined HAL_OTA_BOOT_CODE)
@@ -119,6 +171,36 @@ void HalFlashRead(uint8 pg, uint16 offset, uint8 *buf, uint16 cnt)
  */
 void HalFlashWrite(uint16 addr, uint8 *buf, uint16 cnt)
 {
+#if HAL_FLASH_ASYNC
+  HalFlashFlush();
+#endif
+
+#if (defined HAL_DMA) && (HAL_DMA == TRUE)
+  halFlashWriteStart(addr, buf, cnt);
+  while (FCTL & HAL_FLASH_FCTL_BUSY);  // Wait until writing is done.
+#endif
+}
+
+/**************************************************************************************************
+ * @fn          halFlashWriteStart
+ *
+ * @brief       This function starts the DMA write of 'cnt' bytes to the internal flash.
+ *
+ * input parameters
+ *
+ * @param       addr - Valid HAL flash write address: actual addr / 4 and quad-aligned.
+ * @param       buf - Valid buffer space at least as big as 'cnt' X 4.
+ * @param       cnt - Number of 4-byte blocks to write.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+static void halFlashWriteStart(uint16 addr, uint8 *buf, uint16 cnt)
+{
 #if (defined HAL_DMA) && (HAL_DMA == TRUE)
   halDMADesc_t *ch = HAL_NV_DMA_GET_DESC();
 
@@ -140,8 +222,11 @@ void HalFlashWrite(uint16 addr, uint8 *buf, uint16 cnt)
 
   FADDRL = (uint8)addr;
   FADDRH = (uint8)(addr >> 8);
-  FCTL |= 0x02;         // Trigger the DMA writes.
-  while (FCTL & 0x80);  // Wait until writing is done.
+  FCTL |= HAL_FLASH_FCTL_WRITE;  // Trigger the DMA writes.
+#else
+  (void)addr;
+  (void)buf;
+  (void)cnt;
 #endif
 }
 
@@ -163,9 +248,227 @@ void HalFlashWrite(uint16 addr, uint8 *buf, uint16 cnt)
  */
 void HalFlashErase(uint8 pg)
 {
+#if HAL_FLASH_ASYNC
+  HalFlashFlush();
+#endif
+
   FADDRH = pg * (HAL_FLASH_PAGE_SIZE / HAL_FLASH_WORD_SIZE / 256);
-  FCTL |= 0x01;
+  FCTL |= HAL_FLASH_FCTL_ERASE;
 }
 
+#if HAL_FLASH_ASYNC
+/**************************************************************************************************
+ * @fn          HalFlashWriteAsync
+ *
+ * @brief       This function queues a write of 'cnt' 4-byte blocks to the internal flash. Queued
+ *              requests are started in order from Hal_ProcessPoll(), so the caller's task and any
+ *              other pending OSAL events run before the flash controller is tied up.
+ *
+ * input parameters
+ *
+ * @param       addr - Valid HAL flash write address: actual addr / 4 and quad-aligned.
+ * @param       buf - Valid buffer space at least as big as 'cnt' X 4, kept until 'cBack'.
+ * @param       cnt - Number of 4-byte blocks to write.
+ * @param       cBack - Completion callback or NULL.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void HalFlashWriteAsync(uint16 addr, uint8 *buf, uint16 cnt, halFlashCBack_t cBack)
+{
+  halFlashQueue(buf, addr, cnt, cBack);
+}
+
+/**************************************************************************************************
+ * @fn          HalFlashEraseAsync
+ *
+ * @brief       This function queues an erase of the specified page of the internal flash.
+ *
+ * input parameters
+ *
+ * @param       pg - A valid flash page number to erase.
+ * @param       cBack - Completion callback or NULL.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void HalFlashEraseAsync(uint8 pg, halFlashCBack_t cBack)
+{
+  halFlashQueue(NULL, pg, 0, cBack);
+}
+
+/**************************************************************************************************
+ * @fn          HalFlashPoll
+ *
+ * @brief       This function completes the running request, if the flash controller is done with
+ *              it, and starts the next one. The flash controller has no completion interrupt and
+ *              the DMA one fires before the last word is programmed, so FCTL.BUSY is polled.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void HalFlashPoll(void)
+{
+  halFlashService(FALSE);
+}
+
+/**************************************************************************************************
+ * @fn          HalFlashFlush
+ *
+ * @brief       This function runs all queued requests to completion.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void HalFlashFlush(void)
+{
+  halFlashService(TRUE);
+}
+
+/**************************************************************************************************
+ * @fn          HalFlashBusy
+ *
+ * @brief       This function checks for queued requests.
+ *
+ * input parameters
+ *
+ * None.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      TRUE if a write or erase is queued or running; FALSE otherwise.
+ **************************************************************************************************
+ */
+bool HalFlashBusy(void)
+{
+  return (halFlashQCnt != 0);
+}
+
+/**************************************************************************************************
+ * @fn          halFlashQueue
+ *
+ * @brief       This function adds a request to the queue, first completing the oldest request if
+ *              the queue is full.
+ *
+ * input parameters
+ *
+ * @param       buf - Data to write or NULL for an erase.
+ * @param       addr - Flash write address or page to erase.
+ * @param       cnt - Number of 4-byte blocks to write.
+ * @param       cBack - Completion callback or NULL.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+static void halFlashQueue(uint8 *buf, uint16 addr, uint16 cnt, halFlashCBack_t cBack)
+{
+  halFlashReq_t *req;
+
+  while (halFlashQCnt == HAL_FLASH_Q_MAX)
+  {
+    halFlashService(TRUE);
+  }
+
+  req = halFlashQ + ((halFlashQHead + halFlashQCnt) % HAL_FLASH_Q_MAX);
+  req->buf = buf;
+  req->addr = addr;
+  req->cnt = cnt;
+  req->cBack = cBack;
+  halFlashQCnt++;
+}
+
+/**************************************************************************************************
+ * @fn          halFlashService
+ *
+ * @brief       This function completes and starts queued requests in order.
+ *
+ * input parameters
+ *
+ * @param       wait - TRUE to wait for every request to complete; FALSE to return while the
+ *                     flash controller is busy.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+static void halFlashService(bool wait)
+{
+  while (halFlashQCnt != 0)
+  {
+    halFlashReq_t *req = halFlashQ + halFlashQHead;
+    halFlashCBack_t cBack;
+    uint8 *buf;
+
+    if (!halFlashActive)
+    {
+      if (req->buf == NULL)
+      {
+        FADDRH = (uint8)req->addr * (HAL_FLASH_PAGE_SIZE / HAL_FLASH_WORD_SIZE / 256);
+        FCTL |= HAL_FLASH_FCTL_ERASE;
+      }
+      else
+      {
+        halFlashWriteStart(req->addr, req->buf, req->cnt);
+      }
+      halFlashActive = TRUE;
+    }
+
+    if (FCTL & HAL_FLASH_FCTL_BUSY)
+    {
+      if (!wait)
+      {
+        return;
+      }
+      while (FCTL & HAL_FLASH_FCTL_BUSY);
+    }
+
+    // Dequeue before the callback, which may queue or flush.
+    cBack = req->cBack;
+    buf = req->buf;
+    halFlashActive = FALSE;
+    halFlashQHead = (halFlashQHead + 1) % HAL_FLASH_Q_MAX;
+    halFlashQCnt--;
+
+    if (cBack != NULL)
+    {
+      cBack(buf);
+    }
+  }
+}
+#endif
+
 /**************************************************************************************************
 */
@@ -87,6 +87,7 @@
 #include "hal_drivers.h"
 #include "hal_adc.h"
 #include "hal_key.h"
+#include "hal_sleep.h"
 #include "osal.h"
 
 #if (defined HAL_KEY) && (HAL_KEY == TRUE)
@@ -103,6 +104,21 @@
 
 #define HAL_KEY_DEBOUNCE_VALUE  25
 
+/* Press gestures, interrupt mode only */
+#ifndef HAL_KEY_LONG_MSECS
+#define HAL_KEY_LONG_MSECS      1000  /* Held this long is a long press */
+#endif
+#ifndef HAL_KEY_DOUBLE_MSECS
+#define HAL_KEY_DOUBLE_MSECS    250   /* Window for the 2nd press; 0 reports on release */
+#endif
+#define HAL_KEY_HOLD_MSECS      50    /* Release check period while a key is down */
+
+/* Gesture states */
+#define HAL_KEY_ST_IDLE         0     /* Waiting for an edge, no timer running */
+#define HAL_KEY_ST_HELD         1     /* Down, watching for the release or a long press */
+#define HAL_KEY_ST_LONG         2     /* Long press reported, waiting for the release */
+#define HAL_KEY_ST_WAIT_2ND     3     /* Released once, a press now makes it a double */
+
 /* CPU port interrupt */
 #define HAL_KEY_LINK_CPU_PORT_0_IF P0IF
 
@@ -139,11 +155,17 @@ static halKeyCBack_t pHalKeyProcessFunction;
 static uint8 HalKeyConfigured;
 bool Hal_KeyIntEnable;            /* interrupt enable/disable flag */
 
+static uint8 halKeyState;         /* HAL_KEY_ST_xxx */
+static uint8 halKeyDown;          /* Keys of the current gesture */
+static uint8 halKeyClicks;        /* Presses in the current gesture */
+static uint32 halKeyTime;         /* Time of the last press or release */
+
 /**************************************************************************************************
  *                                        FUNCTIONS - Local
  **************************************************************************************************/
 void halProcessKeyInterrupt(void);
 uint8 halGetJoyKeyInput(void);
+static void halKeyGesture(void);
 
 
 
@@ -172,6 +194,8 @@ void HalKeyInit( void )
 
   /* Start with key is not configured */
   HalKeyConfigured = FALSE;
+
+  halKeyState = HAL_KEY_ST_IDLE;
 }
 
 
@@ -219,6 +243,7 @@ void HalKeyConfig (bool interruptEnable, halKeyCBack_t cback)
     {
       osal_stop_timerEx(Hal_TaskID, HAL_KEY_EVENT);  /* Cancel polling if active */
     }
+    halKeyState = HAL_KEY_ST_IDLE;
   }
   else    /* Interrupts NOT enabled */
   {
@@ -273,6 +298,13 @@ void HalKeyPoll (void)
 {
   uint8 keys = 0;
 
+  /* Interrupt mode runs here only after an edge, until the gesture is over */
+  if (Hal_KeyIntEnable)
+  {
+    halKeyGesture();
+    return;
+  }
+
   if (HAL_PUSH_BUTTON1())
   {
     keys |= HAL_KEY_SW_6; //P0.6 LINK_KEY
@@ -285,6 +317,108 @@ void HalKeyPoll (void)
   }
 }
 
+/**************************************************************************************************
+ * @fn      halKeyGesture
+ *
+ * @brief   Debounced key state machine for interrupt mode. The edge ISR starts a one-shot
+ *          debounce timer, which halSleep() serves from the sleep timer compare. The keys are
+ *          then only checked while down and for the double press window after, so an untouched
+ *          key costs no wakeups. One callback is made per gesture: a press, a long press or a
+ *          double press.
+ *
+ * @param   None
+ *
+ * @return  None
+ **************************************************************************************************/
+static void halKeyGesture (void)
+{
+  uint32 now = osal_GetSystemClock();
+  uint8 state = HAL_KEY_STATE_NORMAL;
+  uint8 keys = 0;
+  bool report = FALSE;
+
+  if (HAL_PUSH_BUTTON1())
+  {
+    keys |= HAL_KEY_SW_6; //P0.6 LINK_KEY
+  }
+
+  switch (halKeyState)
+  {
+  case HAL_KEY_ST_IDLE:
+  case HAL_KEY_ST_WAIT_2ND:
+    if (keys)
+    {
+      /* A debounced press; the second one of a double if in the window */
+      halKeyClicks = (halKeyState == HAL_KEY_ST_WAIT_2ND) ? 2 : 1;
+      halKeyDown = keys;
+      halKeyTime = now;
+      halKeyState = HAL_KEY_ST_HELD;
+      osal_start_timerEx(Hal_TaskID, HAL_KEY_EVENT, HAL_KEY_HOLD_MSECS);
+    }
+    else if (halKeyState == HAL_KEY_ST_WAIT_2ND)
+    {
+      if ((now - halKeyTime) >= HAL_KEY_DOUBLE_MSECS)
+      {
+        report = TRUE;
+        halKeyState = HAL_KEY_ST_IDLE;
+      }
+      else
+      {
+        /* A glitch took over the window timer, give back what is left of it */
+        osal_start_timerEx(Hal_TaskID, HAL_KEY_EVENT,
+                           (uint16)(HAL_KEY_DOUBLE_MSECS - (now - halKeyTime)));
+      }
+    }
+    break;
+
+  case HAL_KEY_ST_HELD:
+    if (keys)
+    {
+      if ((halKeyClicks == 1) && ((now - halKeyTime) >= HAL_KEY_LONG_MSECS))
+      {
+        state = HAL_KEY_STATE_LONG;
+        report = TRUE;
+        halKeyState = HAL_KEY_ST_LONG;
+      }
+      osal_start_timerEx(Hal_TaskID, HAL_KEY_EVENT, HAL_KEY_HOLD_MSECS);
+    }
+    else if (halKeyClicks == 2)
+    {
+      state = HAL_KEY_STATE_DOUBLE;
+      report = TRUE;
+      halKeyState = HAL_KEY_ST_IDLE;
+    }
+    else if (HAL_KEY_DOUBLE_MSECS == 0)
+    {
+      report = TRUE;
+      halKeyState = HAL_KEY_ST_IDLE;
+    }
+    else
+    {
+      halKeyTime = now;
+      halKeyState = HAL_KEY_ST_WAIT_2ND;
+      osal_start_timerEx(Hal_TaskID, HAL_KEY_EVENT, HAL_KEY_DOUBLE_MSECS);
+    }
+    break;
+
+  default:  /* HAL_KEY_ST_LONG */
+    if (keys)
+    {
+      osal_start_timerEx(Hal_TaskID, HAL_KEY_EVENT, HAL_KEY_HOLD_MSECS);
+    }
+    else
+    {
+      halKeyState = HAL_KEY_ST_IDLE;
+    }
+    break;
+  }
+
+  if (report && pHalKeyProcessFunction)
+  {
+    (pHalKeyProcessFunction) (halKeyDown, state);
+  }
+}
+
 /**************************************************************************************************
  * @fn      halGetJoyKeyInput
  *
@@ -410,8 +544,17 @@ HAL_ISR_FUNCTION( halKeyPort0Isr, P0INT_VECTOR )
 {
   HAL_ENTER_ISR();
 
+#if HAL_UART_DMA_EVT
+  /* the UART flow control pin armed by HalUARTSuspend(); any other pin is not a UART wake */
+  if (HAL_KEY_LINK_PXIFG & P0IEN & HAL_UART_WAKE_P0_BIT)
+  {
+    HAL_SLEEP_WAKE_SRC(HAL_SLEEP_WAKE_UART);
+  }
+#endif
+
   if ((HAL_KEY_LINK_PXIFG & HAL_KEY_LINK_BIT))
   {
+    HAL_SLEEP_WAKE_SRC(HAL_SLEEP_WAKE_KEY);
     halProcessKeyInterrupt();
   }
 
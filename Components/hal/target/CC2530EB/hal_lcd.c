@@ -45,6 +45,7 @@
 #include "OSAL.h"
 #include "OnBoard.h"
 #include "hal_assert.h"
+#include "hal_drivers.h"
 
 #if defined (ZTOOL_P1) || defined (ZTOOL_P2)
   #include "DebugTrace.h"
@@ -203,6 +204,13 @@
 
 static uint8 *Lcd_Line1;
 
+/* Shadow of the display. Writes only land here and mark the cells that changed; the Hal task
+ * sends just those cells from HalLcdFlush(), so a live value costs a few SPI bytes, not a line.
+ */
+static char   lcdFb[LCD_MAX_LINE_COUNT][LCD_MAX_LINE_LENGTH];
+static uint16 lcdFbDirty[LCD_MAX_LINE_COUNT];   /* BV(col) per cell differing from the display */
+static bool   lcdFbPending;                     /* HAL_LCD_EVENT is set */
+
 /**************************************************************************************************
  *                                       FUNCTIONS - API
  **************************************************************************************************/
@@ -487,6 +495,57 @@ void HalLcdDisplayPercentBar( char *title, uint8 value )
 
 }
 
+/**************************************************************************************************
+ * @fn      HalLcdFlush
+ *
+ * @brief   Send the cells changed since the last flush to the display. Runs from the Hal task on
+ *          HAL_LCD_EVENT, after the writer's event has returned; call it directly to sync now.
+ *
+ * @param   None
+ *
+ * @return  None
+ **************************************************************************************************/
+void HalLcdFlush( void )
+{
+#if (HAL_LCD == TRUE)
+  uint8 line;
+
+  lcdFbPending = FALSE;
+
+  for (line = 0; line < LCD_MAX_LINE_COUNT; line++)
+  {
+    uint16 dirty = lcdFbDirty[line];
+    uint8 col = 0;
+
+    lcdFbDirty[line] = 0;
+
+    while (dirty)
+    {
+      if (!(dirty & 0x01))
+      {
+        dirty >>= 1;
+        col++;
+        continue;
+      }
+
+      /* One address for the run of changed cells, the DDRAM address auto-increments */
+      SET_DDRAM_ADDR(line * LCD_MAX_LINE_LENGTH + col);
+
+      LCD_SPI_BEGIN();
+      LCD_DO_WRITE();
+      do
+      {
+        LCD_SPI_TX(lcdFb[line][col]);
+        LCD_SPI_WAIT_RXRDY();
+        dirty >>= 1;
+        col++;
+      } while (dirty & 0x01);
+      LCD_SPI_END();
+    }
+  }
+#endif
+}
+
 #if (HAL_LCD == TRUE)
 /**************************************************************************************************
  *                                    HARDWARE LCD
@@ -657,6 +716,10 @@ void HalLcd_HW_Clear(void)
   {
     HalLcd_HW_Write(' ');
   }
+
+  /* The display now matches a blank shadow */
+  (void)osal_memset(lcdFb, ' ', sizeof(lcdFb));
+  (void)osal_memset(lcdFbDirty, 0, sizeof(lcdFbDirty));
 }
 
 /**************************************************************************************************
@@ -682,7 +745,7 @@ void HalLcd_HW_ClearAllSpecChars(void)
 /**************************************************************************************************
  * @fn      HalLcd_HW_WriteChar
  *
- * @brief   Write one char to the display
+ * @brief   Write one char to the display shadow; a changed cell is sent by HalLcdFlush()
  *
  * @param   uint8 line - line number that the char will be displayed
  *          uint8 col - colum where the char will be displayed
@@ -691,14 +754,21 @@ void HalLcd_HW_ClearAllSpecChars(void)
  **************************************************************************************************/
 void HalLcd_HW_WriteChar(uint8 line, uint8 col, char text)
 {
-  if (col < LCD_MAX_LINE_LENGTH)
+  if ((line == 0) || (line > LCD_MAX_LINE_COUNT) || (col >= LCD_MAX_LINE_LENGTH))
   {
-    SET_DDRAM_ADDR((line - 1) * LCD_MAX_LINE_LENGTH + col);
-    HalLcd_HW_Write(text);
+    return;
   }
-  else
+
+  if (lcdFb[line - 1][col] != text)
   {
-    return;
+    lcdFb[line - 1][col] = text;
+    lcdFbDirty[line - 1] |= (uint16)1 << col;
+
+    if (!lcdFbPending)
+    {
+      lcdFbPending = TRUE;
+      osal_set_event(Hal_TaskID, HAL_LCD_EVENT);
+    }
   }
 }
 
@@ -51,6 +51,10 @@
 /***************************************************************************************************
  *                                             CONSTANTS
  ***************************************************************************************************/
+/* Most a blink edge may move to share a wakeup, kept under a quarter of the phase */
+#ifndef HAL_LED_SLACK_MSECS
+#define HAL_LED_SLACK_MSECS   20
+#endif
 
 /***************************************************************************************************
  *                                              MACROS
@@ -65,6 +69,7 @@ typedef struct {
   uint8 todo;       /* Blink cycles left */
   uint8 onPct;      /* On cycle percentage */
   uint16 time;      /* On/off cycle time (msec) */
+  uint16 slack;     /* How far the next change may move (msec) */
   uint32 next;      /* Time for next change */
 } HalLedControl_t;
 
@@ -215,11 +220,28 @@ void HalLedBlink (uint8 leds, uint8 numBlinks, uint8 percent, uint16 period)
 #if (defined (BLINK_LEDS)) && (HAL_LED == TRUE)
   uint8 led;
   HalLedControl_t *sts;
+  HalLedControl_t *peer;
 
   if (leds && percent && period)
   {
     if (percent < 100)
     {
+      /* Continuous blinks join the phase of a like one already running, to share its wakeups */
+      peer = NULL;
+      if (!numBlinks)
+      {
+        for (led = 0; led < HAL_LED_DEFAULT_MAX_LEDS; led++)
+        {
+          sts = &HalLedStatusControl.HalLedControlTable[led];
+          if (!(leds & (1 << led)) && (sts->mode & HAL_LED_MODE_BLINK) &&
+              (sts->mode & HAL_LED_MODE_FLASH) && (sts->time == period) && (sts->onPct == percent))
+          {
+            peer = sts;
+            break;
+          }
+        }
+      }
+
       led = HAL_LED_1;
       leds &= HAL_LED_ALL;
       sts = HalLedStatusControl.HalLedControlTable;
@@ -238,6 +260,14 @@ void HalLedBlink (uint8 leds, uint8 numBlinks, uint8 percent, uint16 period)
           sts->todo  = numBlinks;                           /* Number of blink cycles */
           if (!numBlinks) sts->mode |= HAL_LED_MODE_FLASH;  /* Continuous */
           sts->next = osal_GetSystemClock();                /* Start now */
+          sts->slack = 0;
+          if (peer)
+          {
+            sts->mode |= peer->mode & HAL_LED_MODE_ON;      /* Start in step with the peer */
+            HalLedOnOff (led, sts->mode & HAL_LED_MODE_ON);
+            sts->next  = peer->next;
+            sts->slack = peer->slack;
+          }
           sts->mode |= HAL_LED_MODE_BLINK;                  /* Enable blinking */
           leds ^= led;
         }
@@ -285,9 +315,11 @@ void HalLedUpdate (void)
   HalLedControl_t *sts;
   uint32 time;
   uint16 next;
+  uint16 nextSlack;
   uint16 wait;
 
   next = 0;
+  nextSlack = 0;
   led  = HAL_LED_1;
   leds = HAL_LED_ALL;
   sts = HalLedStatusControl.HalLedControlTable;
@@ -302,7 +334,8 @@ void HalLedUpdate (void)
         if (sts->mode & HAL_LED_MODE_BLINK)
         {
           time = osal_GetSystemClock();
-          if (time >= sts->next)
+          /* Changes due within their slack are made now, so one wakeup serves them all */
+          if ((time + sts->slack) >= sts->next)
           {
             if (sts->mode & HAL_LED_MODE_ON)
             {
@@ -329,7 +362,24 @@ void HalLedUpdate (void)
             if (sts->mode & HAL_LED_MODE_BLINK)
             {
               wait = (((uint32)pct * (uint32)sts->time) / 100);
-              sts->next = time + wait;
+              if (!wait)
+              {
+                wait = 1;
+              }
+
+              /* Step from the planned time so early or late changes don't drift the pattern */
+              sts->next += wait;
+              if ((sts->next <= time) || ((sts->next - time) > sts->time))
+              {
+                sts->next = time + wait;
+              }
+              wait = (uint16)(sts->next - time);
+
+              sts->slack = wait / 4;
+              if (sts->slack > HAL_LED_SLACK_MSECS)
+              {
+                sts->slack = HAL_LED_SLACK_MSECS;
+              }
             }
             else
             {
@@ -349,6 +399,7 @@ void HalLedUpdate (void)
           if (!next || ( wait && (wait < next) ))
           {
             next = wait;
+            nextSlack = sts->slack;
           }
         }
         leds ^= led;
@@ -360,6 +411,7 @@ void HalLedUpdate (void)
     if (next)
     {
       osal_start_timerEx(Hal_TaskID, HAL_LED_BLINK_EVENT, next);   /* Schedule event */
+      osal_timer_slack(Hal_TaskID, HAL_LED_BLINK_EVENT, nextSlack);
     }
   }
 }
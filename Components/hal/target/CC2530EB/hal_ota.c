@@ -63,6 +63,30 @@
 #define XNV_READ_CMD  0x0B
 
 #define XNV_STAT_WIP  0x01
+
+// Page-aligned read cache; a power of 2 that divides the 256-byte XNV page.
+#if !defined HAL_OTA_XNV_CACHE_SIZE
+#define HAL_OTA_XNV_CACHE_SIZE  64
+#endif
+
+// Burst reads by DMA in the application; the boot code keeps to Channel 0 for flash writes.
+// Not when HalDmaInit() leaves no channel for HalDmaAlloc() (see HAL_DMA_ALLOC_FREE).
+#if (defined HAL_DMA) && (HAL_DMA == TRUE) && HAL_DMA_ALLOC_FREE && !HAL_OTA_BOOT_CODE
+#define HAL_OTA_XNV_DMA  TRUE
+#define HAL_DMA_U1DBUF   0x70F9
+#else
+#define HAL_OTA_XNV_DMA  FALSE
+#endif
+#endif
+
+// Bytes of the image read at a time by the CRC checks.
+#define HAL_OTA_CRC_BUF_SIZE  16
+
+#if HAL_FLASH_ASYNC
+// Largest block that HalOTAWrite() queues instead of writing in place.
+#if !defined HAL_OTA_WRITE_BUF_SIZE
+#define HAL_OTA_WRITE_BUF_SIZE  64
+#endif
 #endif
 
 /******************************************************************************
@@ -83,15 +107,34 @@ OTA_CrcControl_t OTA_crcControl;
 halDMADesc_t dmaCh0;
 #endif
 
+#if HAL_FLASH_ASYNC
+static uint8 otaWriteBuf[HAL_OTA_WRITE_BUF_SIZE];
+#endif
+
+#if HAL_OTA_XNV_IS_SPI
+// The boot code runs without C start-up, so xnvCacheValid is cleared with XNV_SPI_INIT().
+static uint8 xnvCache[HAL_OTA_XNV_CACHE_SIZE];
+static uint32 xnvCacheAddr;
+static bool xnvCacheValid;
+#if HAL_OTA_XNV_DMA
+static uint8 xnvSPIDummy;
+#endif
+#endif
+
 /******************************************************************************
  * LOCAL FUNCTIONS
  */
 static uint16 runPoly(uint16 crc, uint8 val);
+static uint16 runPolyBuf(uint16 crc, uint32 oset, uint8 *pBuf, uint8 len);
 
 #if HAL_OTA_XNV_IS_SPI
 static void HalSPIRead(uint32 addr, uint8 *pBuf, uint16 len);
 static void HalSPIWrite(uint32 addr, uint8 *pBuf, uint16 len);
 static void xnvSPIWrite(uint8 ch);
+static void xnvSPIBurst(uint32 addr, uint8 *pBuf, uint16 len);
+#if HAL_OTA_XNV_DMA
+static bool xnvSPIReadDMA(uint8 *pBuf, uint16 len);
+#endif
 #endif
 
 #if HAL_OTA_BOOT_CODE
@@ -113,6 +156,7 @@ void main(void)
   HAL_BOARD_INIT();
 #if HAL_OTA_XNV_IS_SPI
   XNV_SPI_INIT();
+  xnvCacheValid = FALSE;
 #endif
   /* This is in place of calling HalDmaInit() which would require init of the
    * other 4 DMA descriptors in addition to just Channel 0.
@@ -191,16 +235,20 @@ static uint16 crcCalc()
 {
   uint32 oset;
   uint16 crc = 0;
+  uint8 buf[HAL_OTA_CRC_BUF_SIZE];
+  uint8 cnt;
 
   // Run the CRC calculation over the active body of code.
-  for (oset = 0; oset < OTA_crcControl.programSize; oset++)
+  for (oset = 0; oset < OTA_crcControl.programSize; oset += cnt)
   {
-    if ((oset < HAL_OTA_CRC_OSET) || (oset >= HAL_OTA_CRC_OSET + 4))
+    cnt = HAL_OTA_CRC_BUF_SIZE;
+    if (cnt > OTA_crcControl.programSize - oset)
     {
-      uint8 buf;
-      HalOTARead(oset, &buf, 1, HAL_OTA_RC);
-      crc = runPoly(crc, buf);
+      cnt = (uint8)(OTA_crcControl.programSize - oset);
     }
+
+    HalOTARead(oset, buf, cnt, HAL_OTA_RC);
+    crc = runPolyBuf(crc, oset, buf, cnt);
   }
 
   return crc;
@@ -234,6 +282,34 @@ static uint16 runPoly(uint16 crc, uint8 val)
   return crc;
 }
 
+/******************************************************************************
+ * @fn      runPolyBuf
+ *
+ * @brief   Run the CRC16 Polynomial calculation over a block of the image,
+ *          skipping the 4 bytes of the CRC itself.
+ *
+ * @param   crc - Running CRC calculated so far.
+ * @param   oset - Offset of the block into the program.
+ * @param   pBuf - Pointer to the block.
+ * @param   len - Number of bytes in the block.
+ *
+ * @return  crc - Updated for the run.
+ */
+static uint16 runPolyBuf(uint16 crc, uint32 oset, uint8 *pBuf, uint8 len)
+{
+  uint8 idx;
+
+  for (idx = 0; idx < len; idx++, oset++)
+  {
+    if ((oset < HAL_OTA_CRC_OSET) || (oset >= HAL_OTA_CRC_OSET + 4))
+    {
+      crc = runPoly(crc, pBuf[idx]);
+    }
+  }
+
+  return crc;
+}
+
 /******************************************************************************
  * @fn      HalOTAChkDL
  *
@@ -252,9 +328,12 @@ uint8 HalOTAChkDL(uint8 dlImagePreambleOffset)
   OTA_CrcControl_t crcControl;
   OTA_ImageHeader_t header;
   uint32 programStart;
+  uint8 buf[HAL_OTA_CRC_BUF_SIZE];
+  uint8 cnt;
 
 #if HAL_OTA_XNV_IS_SPI
   XNV_SPI_INIT();
+  xnvCacheValid = FALSE;
 #endif
 
   // Read the OTA File Header
@@ -272,14 +351,16 @@ uint8 HalOTAChkDL(uint8 dlImagePreambleOffset)
   }
 
   // Run the CRC calculation over the downloaded image.
-  for (oset = 0; oset < crcControl.programSize; oset++)
+  for (oset = 0; oset < crcControl.programSize; oset += cnt)
   {
-    if ((oset < HAL_OTA_CRC_OSET) || (oset >= HAL_OTA_CRC_OSET+4))
+    cnt = HAL_OTA_CRC_BUF_SIZE;
+    if (cnt > crcControl.programSize - oset)
     {
-      uint8 buf;
-      HalOTARead(oset + programStart, &buf, 1, HAL_OTA_DL);
-      crc = runPoly(crc, buf);
+      cnt = (uint8)(crcControl.programSize - oset);
     }
+
+    HalOTARead(oset + programStart, buf, cnt, HAL_OTA_DL);
+    crc = runPolyBuf(crc, oset, buf, cnt);
   }
 
   return (crcControl.crc[0] == crc) ? SUCCESS : FAILURE;
@@ -370,6 +451,31 @@ void HalOTAWrite(uint32 oset, uint8 *pBuf, uint16 len, image_t type)
     oset += HAL_OTA_RC_START;
   }
 
+#if HAL_FLASH_ASYNC
+  /* Queue the erase and a copy of the block so that the caller returns right away; the previous
+   * block is long written by the time the next one arrives, so waiting for it costs nothing.
+   */
+  if (len <= HAL_OTA_WRITE_BUF_SIZE)
+  {
+    uint16 idx;
+
+    HalFlashFlush();
+
+    if ((oset % HAL_FLASH_PAGE_SIZE) == 0)
+    {
+      HalFlashEraseAsync(oset / HAL_FLASH_PAGE_SIZE, NULL);
+    }
+
+    for (idx = 0; idx < len; idx++)
+    {
+      otaWriteBuf[idx] = pBuf[idx];
+    }
+
+    HalFlashWriteAsync(oset / HAL_FLASH_WORD_SIZE, otaWriteBuf, len / HAL_FLASH_WORD_SIZE, NULL);
+    return;
+  }
+#endif
+
   if ((oset % HAL_FLASH_PAGE_SIZE) == 0)
   {
     HalFlashErase(oset / HAL_FLASH_PAGE_SIZE);
@@ -411,7 +517,10 @@ static void xnvSPIWrite(uint8 ch)
 /******************************************************************************
  * @fn      HalSPIRead
  *
- * @brief   Read from the external NV storage via SPI.
+ * @brief   Read from the external NV storage via SPI. Reads are served from a
+ *          cache of one aligned HAL_OTA_XNV_CACHE_SIZE block, which is filled by
+ *          a single burst; so the small sequential reads of the OTA code cost one
+ *          SPI command per block. Whole aligned blocks go straight to the caller.
  *
  * @param   addr - Offset into the external NV.
  * @param   pBuf - Pointer to buffer to copy the bytes read from external NV.
@@ -420,6 +529,60 @@ static void xnvSPIWrite(uint8 ch)
  * @return  None.
  *****************************************************************************/
 static void HalSPIRead(uint32 addr, uint8 *pBuf, uint16 len)
+{
+  uint32 base;
+  uint16 cnt;
+  uint8 idx;
+
+  while (len)
+  {
+    base = addr & ~((uint32)HAL_OTA_XNV_CACHE_SIZE - 1);
+
+    if (!xnvCacheValid || (xnvCacheAddr != base))
+    {
+      if ((addr == base) && (len >= HAL_OTA_XNV_CACHE_SIZE))
+      {
+        cnt = len & ~(HAL_OTA_XNV_CACHE_SIZE - 1);
+        xnvSPIBurst(addr, pBuf, cnt);
+        addr += cnt;
+        pBuf += cnt;
+        len -= cnt;
+        continue;
+      }
+
+      xnvSPIBurst(base, xnvCache, HAL_OTA_XNV_CACHE_SIZE);
+      xnvCacheAddr = base;
+      xnvCacheValid = TRUE;
+    }
+
+    idx = (uint8)(addr - base);
+    cnt = HAL_OTA_XNV_CACHE_SIZE - idx;
+    if (cnt > len)
+    {
+      cnt = len;
+    }
+
+    addr += cnt;
+    len -= cnt;
+    while (cnt--)
+    {
+      *pBuf++ = xnvCache[idx++];
+    }
+  }
+}
+
+/******************************************************************************
+ * @fn      xnvSPIBurst
+ *
+ * @brief   Read a block from the external NV storage with one read command.
+ *
+ * @param   addr - Offset into the external NV.
+ * @param   pBuf - Pointer to buffer to copy the bytes read from external NV.
+ * @param   len - Number of bytes to read from external NV.
+ *
+ * @return  None.
+ *****************************************************************************/
+static void xnvSPIBurst(uint32 addr, uint8 *pBuf, uint16 len)
 {
 #if !HAL_OTA_BOOT_CODE
   uint8 shdw = P1DIR;
@@ -443,10 +606,15 @@ static void HalSPIRead(uint32 addr, uint8 *pBuf, uint16 len)
   xnvSPIWrite(addr);
   xnvSPIWrite(0);
 
-  while (len--)
+#if HAL_OTA_XNV_DMA
+  if (!xnvSPIReadDMA(pBuf, len))
+#endif
   {
-    xnvSPIWrite(0);
-    *pBuf++ = XNV_SPI_RX();
+    while (len--)
+    {
+      xnvSPIWrite(0);
+      *pBuf++ = XNV_SPI_RX();
+    }
   }
   XNV_SPI_END();
 
@@ -477,6 +645,8 @@ static void HalSPIWrite(uint32 addr, uint8 *pBuf, uint16 len)
   P1DIR |= BV(3);
 #endif
 
+  xnvCacheValid = FALSE;
+
   while (len)
   {
     XNV_SPI_BEGIN();
@@ -524,6 +694,81 @@ static void HalSPIWrite(uint32 addr, uint8 *pBuf, uint16 len)
 #endif
 }
 
+#if HAL_OTA_XNV_DMA
+/******************************************************************************
+ * @fn      xnvSPIReadDMA
+ *
+ * @brief   Clock in a block from the SPI by a pair of DMA channels: one feeds
+ *          dummy bytes on each Tx complete, the other stores each Rx byte. The
+ *          first dummy byte is written here to start the chain.
+ *
+ * @param   pBuf - Pointer to buffer to copy the bytes read from external NV.
+ * @param   len - Number of bytes to read, up to HAL_DMA_LEN_MAX.
+ *
+ * @return  TRUE if read, FALSE if no channels were free and the caller must read.
+ *****************************************************************************/
+static bool xnvSPIReadDMA(uint8 *pBuf, uint16 len)
+{
+  halDMADesc_t *pDesc;
+  uint8 ch;
+
+  if ((len < 2) || (len > HAL_DMA_LEN_MAX))
+  {
+    return FALSE;
+  }
+
+  ch = HalDmaAlloc(2, HAL_DMA_PRI_HIGH, NULL);
+  if (ch == HAL_DMA_CH_NONE)
+  {
+    return FALSE;
+  }
+
+  // Rx: U1DBUF to the buffer on each byte received.
+  pDesc = HAL_DMA_GET_DESC1234(ch);
+  HAL_DMA_SET_SOURCE(pDesc, HAL_DMA_U1DBUF);
+  HAL_DMA_SET_DEST(pDesc, pBuf);
+  HAL_DMA_SET_VLEN(pDesc, HAL_DMA_VLEN_USE_LEN);
+  HAL_DMA_SET_LEN(pDesc, len);
+  HAL_DMA_SET_WORD_SIZE(pDesc, HAL_DMA_WORDSIZE_BYTE);
+  HAL_DMA_SET_TRIG_MODE(pDesc, HAL_DMA_TMODE_SINGLE);
+  HAL_DMA_SET_TRIG_SRC(pDesc, HAL_DMA_TRIG_URX1);
+  HAL_DMA_SET_SRC_INC(pDesc, HAL_DMA_SRCINC_0);
+  HAL_DMA_SET_DST_INC(pDesc, HAL_DMA_DSTINC_1);
+  HAL_DMA_SET_IRQ(pDesc, HAL_DMA_IRQMASK_DISABLE);
+  HAL_DMA_SET_M8(pDesc, HAL_DMA_M8_USE_8_BITS);
+  HAL_DMA_SET_PRIORITY(pDesc, HAL_DMA_PRI_HIGH);
+
+  // Tx: the remaining dummy bytes to U1DBUF on each byte sent.
+  pDesc = HAL_DMA_GET_DESC1234(ch + 1);
+  HAL_DMA_SET_SOURCE(pDesc, &xnvSPIDummy);
+  HAL_DMA_SET_DEST(pDesc, HAL_DMA_U1DBUF);
+  HAL_DMA_SET_VLEN(pDesc, HAL_DMA_VLEN_USE_LEN);
+  HAL_DMA_SET_LEN(pDesc, len - 1);
+  HAL_DMA_SET_WORD_SIZE(pDesc, HAL_DMA_WORDSIZE_BYTE);
+  HAL_DMA_SET_TRIG_MODE(pDesc, HAL_DMA_TMODE_SINGLE);
+  HAL_DMA_SET_TRIG_SRC(pDesc, HAL_DMA_TRIG_UTX1);
+  HAL_DMA_SET_SRC_INC(pDesc, HAL_DMA_SRCINC_0);
+  HAL_DMA_SET_DST_INC(pDesc, HAL_DMA_DSTINC_0);
+  HAL_DMA_SET_IRQ(pDesc, HAL_DMA_IRQMASK_DISABLE);
+  HAL_DMA_SET_M8(pDesc, HAL_DMA_M8_USE_8_BITS);
+  HAL_DMA_SET_PRIORITY(pDesc, HAL_DMA_PRI_HIGH);
+
+  HAL_DMA_ARM_CH(ch);
+  HAL_DMA_ARM_CH(ch + 1);
+  do
+  {
+    asm("NOP");
+  } while (!HAL_DMA_CH_ARMED(ch) || !HAL_DMA_CH_ARMED(ch + 1));
+
+  XNV_SPI_TX(0);
+  while (HAL_DMA_CH_ARMED(ch));
+
+  HalDmaFree(ch, 2);
+
+  return TRUE;
+}
+#endif
+
 #elif !HAL_OTA_XNV_IS_INT
 #error Invalid Xtra-NV for OTA.
 #endif
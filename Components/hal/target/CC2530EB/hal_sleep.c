@@ -55,6 +55,9 @@
 #include "OnBoard.h"
 #include "hal_drivers.h"
 #include "hal_assert.h"
+#include "hal_uart.h"
+#include "hal_flash.h"
+#include "hal_timer.h"
 #include "mac_mcu.h"
 
 #ifndef ZG_BUILD_ENDDEVICE_TYPE
@@ -122,6 +125,14 @@ void halSetSleepMode(void);
  */
 #define HAL_SLEEP_ADJ_TICKS   (11 + 12)
 
+#if HAL_SLEEP_STATS
+/* reason the last sleep attempt was given up, so each is counted once per occurrence */
+#define HAL_SLEEP_VETO_NONE   0
+#define HAL_SLEEP_VETO_ISR    1
+#define HAL_SLEEP_VETO_MAC    2
+#define HAL_SLEEP_VETO_SHORT  3
+#endif
+
 #ifndef HAL_SLEEP_DEBUG_POWER_MODE
 /* set CC2530 power mode; always use PM2 */
 #define HAL_SLEEP_PREP_POWER_MODE(mode)     st( SLEEPCMD &= ~PMODE; /* clear mode bits */    \
@@ -186,6 +197,11 @@ void halSetSleepMode(void);
 /* PCON register value to program when setting power mode */
 volatile __data uint8 halSleepPconValue = PCON_IDLE;
 
+#if HAL_SLEEP_STATS
+/* Wake cause recorded by the first ISR to run after the PCON write */
+volatile uint8 halSleepWakeSrc = HAL_SLEEP_WAKE_NONE;
+#endif
+
 /* ------------------------------------------------------------------------------------------------
  *                                        Local Variables
  * ------------------------------------------------------------------------------------------------
@@ -199,12 +215,26 @@ static uint8 halPwrMgtMode = HAL_SLEEP_OFF;
 static bool halSleepInt = FALSE;
 #endif
 
+#if HAL_SLEEP_STATS
+static halSleepStats_t halSleepStats;
+
+/* sleep timer value at the last power mode change */
+static uint32 halSleepStamp;
+
+/* HAL_SLEEP_VETO_xxx of the last sleep attempt */
+static uint8 halSleepVeto = HAL_SLEEP_VETO_NONE;
+#endif
+
 /* ------------------------------------------------------------------------------------------------
  *                                      Function Prototypes
  * ------------------------------------------------------------------------------------------------
  */
 
 void halSleepSetTimer(uint32 timeout);
+#if HAL_SLEEP_STATS
+static void halSleepAccount(uint8 pm);
+static void halSleepVetoed(uint8 veto);
+#endif
 
 /**************************************************************************************************
  * @fn          halSleep
@@ -251,12 +281,34 @@ void halSleep( uint16 osal_timeout )
 {
   uint32        timeout;
   uint32        macTimeout = 0;
+#if HAL_SLEEP_STATS
+  uint8         timerSrc = HAL_SLEEP_WAKE_OSAL;
+#endif
+
+#if HAL_FLASH_ASYNC
+  /* queued flash writes and erases are run from Hal_ProcessPoll, stay awake for them */
+  if (HalFlashBusy())
+  {
+    return;
+  }
+#endif
+
+#if (defined HAL_TIMER) && (HAL_TIMER == TRUE)
+  /* Timers 1, 3 and 4 run on the system clock and would stop in PM2/3 */
+  if (HalTimerBusy())
+  {
+    return;
+  }
+#endif
 
   /* get next OSAL timer expiration converted to 320 usec units */
   timeout = HAL_SLEEP_MS_TO_320US(osal_timeout);
   if (timeout == 0)
   {
     timeout = MAC_PwrNextTimeout();
+#if HAL_SLEEP_STATS
+    timerSrc = HAL_SLEEP_WAKE_MAC;
+#endif
   }
   else
   {
@@ -267,6 +319,9 @@ void halSleep( uint16 osal_timeout )
     if ((macTimeout != 0) && (macTimeout < timeout))
     {
       timeout = macTimeout;
+#if HAL_SLEEP_STATS
+      timerSrc = HAL_SLEEP_WAKE_MAC;
+#endif
     }
   }
 
@@ -304,6 +359,13 @@ void halSleep( uint16 osal_timeout )
       HalKeyEnterSleep();
 #endif
 
+#if HAL_UART_DMA_EVT
+      /* hold off the peer by RTS and let CTS wake us, since the Rx DMA stops in PM2/3;
+       * a port opened without flow control holds the power manager and never gets here
+       */
+      HalUARTSuspend();
+#endif
+
 #ifdef HAL_SLEEP_DEBUG_LED
       HAL_TURN_OFF_LED3();
 #else
@@ -341,6 +403,13 @@ void halSleep( uint16 osal_timeout )
       }
 #endif
 
+#if HAL_SLEEP_STATS
+      /* close the active period; the first waking ISR records why we woke */
+      halSleepAccount(HAL_SLEEP_PM_ACTIVE);
+      halSleepWakeSrc = HAL_SLEEP_WAKE_NONE;
+      halSleepVeto = HAL_SLEEP_VETO_NONE;
+#endif
+
       /* Prep CC2530 power mode */
       HAL_SLEEP_PREP_POWER_MODE(halPwrMgtMode);
 
@@ -376,9 +445,39 @@ void halSleep( uint16 osal_timeout )
       (void)HalKeyExitSleep();
 #endif
 
+#if HAL_UART_DMA_EVT
+      HalUARTResume();
+#endif
+
       /* power on the MAC; blocks until completion */
       MAC_PwrOnReq();
 
+#ifdef POWER_SAVING
+      /* expiries found late on the next timer update were deferred to this wakeup */
+      osal_timer_wakeup();
+#endif
+
+#if HAL_SLEEP_STATS
+      /* MAC_PwrOnReq() has resynchronized to the 32 kHz clock, so the sleep timer reads true */
+      {
+        uint8 pm = (halPwrMgtMode == HAL_SLEEP_DEEP) ? HAL_SLEEP_PM_DEEP : HAL_SLEEP_PM_TIMER;
+
+        halSleepAccount(pm);
+        halSleepStats.pmCnt[pm]++;
+        halSleepStats.pmCnt[HAL_SLEEP_PM_ACTIVE]++;
+      }
+
+      if (halSleepWakeSrc == HAL_SLEEP_WAKE_NONE)
+      {
+        halSleepWakeSrc = HAL_SLEEP_WAKE_OTHER;
+      }
+      else if (halSleepWakeSrc == HAL_SLEEP_WAKE_OSAL)
+      {
+        halSleepWakeSrc = timerSrc;
+      }
+      halSleepStats.wakeCnt[halSleepWakeSrc]++;
+#endif
+
       HAL_ENABLE_INTERRUPTS();
 
       /* For CC2530, T2 interrupt wont be generated when the current count is greater than
@@ -393,12 +492,22 @@ void halSleep( uint16 osal_timeout )
     }
     else
     {
+#if HAL_SLEEP_STATS
+      halSleepVetoed((halSleepPconValue == 0) ? HAL_SLEEP_VETO_ISR : HAL_SLEEP_VETO_MAC);
+#endif
+
       /* An interrupt may have changed the sleep decision. Do not sleep at all. Turn on
        * the interrupt, exit normally, and the next sleep will be allowed.
        */
       HAL_ENABLE_INTERRUPTS();
     }
   }
+#if HAL_SLEEP_STATS
+  else
+  {
+    halSleepVetoed(HAL_SLEEP_VETO_SHORT);
+  }
+#endif
 }
 
 /**************************************************************************************************
@@ -489,6 +598,117 @@ void halRestoreSleepLevel( void )
   /* Stubs */
 }
 
+#if HAL_SLEEP_STATS
+/**************************************************************************************************
+ * @fn          halSleepAccount
+ *
+ * @brief       Charge the sleep timer ticks elapsed since the last power mode change to the
+ *              given power mode. Must be called with interrupts disabled.
+ *
+ * input parameters
+ *
+ * @param       pm - Power mode that just ended, HAL_SLEEP_PM_ACTIVE .. HAL_SLEEP_PM_DEEP.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+static void halSleepAccount(uint8 pm)
+{
+  uint32 ticks;
+
+  /* read the sleep timer; ST0 must be read first */
+  ((uint8 *) &ticks)[UINT32_NDX0] = ST0;
+  ((uint8 *) &ticks)[UINT32_NDX1] = ST1;
+  ((uint8 *) &ticks)[UINT32_NDX2] = ST2;
+  ((uint8 *) &ticks)[UINT32_NDX3] = 0;
+
+  /* the sleep timer is 24 bits and wraps every 512 seconds */
+  halSleepStats.pmTicks[pm] += (ticks - halSleepStamp) & 0x00FFFFFF;
+  halSleepStamp = ticks;
+}
+
+/**************************************************************************************************
+ * @fn          halSleepVetoed
+ *
+ * @brief       Count a sleep attempt that was given up, unless the previous attempt was given up
+ *              for the same reason: the idle OSAL loop calls halSleep() again on every pass.
+ *
+ * input parameters
+ *
+ * @param       veto - HAL_SLEEP_VETO_ISR, HAL_SLEEP_VETO_MAC or HAL_SLEEP_VETO_SHORT.
+ *
+ * output parameters
+ *
+ * None.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+static void halSleepVetoed(uint8 veto)
+{
+  if (veto != halSleepVeto)
+  {
+    halSleepVeto = veto;
+
+    if (veto == HAL_SLEEP_VETO_ISR)
+    {
+      halSleepStats.vetoIsr++;
+    }
+    else if (veto == HAL_SLEEP_VETO_MAC)
+    {
+      halSleepStats.vetoMac++;
+    }
+    else
+    {
+      halSleepStats.tooShort++;
+    }
+  }
+}
+
+/**************************************************************************************************
+ * @fn          halSleepGetStats
+ *
+ * @brief       Copy out the time spent in each power mode, the wake causes and the number of
+ *              sleeps that were skipped or refused. Time in PM0 is brought up to date on each
+ *              sleep and each call, which must happen at least every 512 seconds to be exact.
+ *
+ * input parameters
+ *
+ * @param       clear - TRUE to restart the accounting after copying it out.
+ *
+ * output parameters
+ *
+ * @param       stats - Buffer for the accounting, may be NULL to only clear it.
+ *
+ * @return      None.
+ **************************************************************************************************
+ */
+void halSleepGetStats(halSleepStats_t *stats, uint8 clear)
+{
+  halIntState_t intState;
+
+  HAL_ENTER_CRITICAL_SECTION(intState);
+
+  halSleepAccount(HAL_SLEEP_PM_ACTIVE);
+
+  if (stats != NULL)
+  {
+    *stats = halSleepStats;
+  }
+
+  if (clear)
+  {
+    (void)osal_memset(&halSleepStats, 0, sizeof(halSleepStats_t));
+  }
+
+  HAL_EXIT_CRITICAL_SECTION(intState);
+}
+#endif
+
 /**************************************************************************************************
  * @fn          halSleepTimerIsr
  *
@@ -510,6 +730,9 @@ HAL_ISR_FUNCTION(halSleepTimerIsr, ST_VECTOR)
   HAL_ENTER_ISR();
   HAL_SLEEP_TIMER_CLEAR_INT();
 
+  /* halSleep() tells the OSAL and MAC timeouts apart */
+  HAL_SLEEP_WAKE_SRC(HAL_SLEEP_WAKE_OSAL);
+
 #ifdef HAL_SLEEP_DEBUG_POWER_MODE
   halSleepInt = TRUE;
 #endif
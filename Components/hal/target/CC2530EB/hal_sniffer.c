@@ -0,0 +1,278 @@
+/**************************************************************************************************
+  Filename:       hal_sniffer.c
+
+  Description:    Streams received frames over the UART for packet capture.
+
+
+  Added to this Z-Stack tree in 2026; not part of the Texas Instruments release. It only
+  builds into the Z-Stack and is distributed under the same license as the Texas Instruments
+  sources it is built with, as stated in their file headers (e.g. hal_dma.c).
+**************************************************************************************************/
+
+/***************************************************************************************************
+ *                                             INCLUDES
+ ***************************************************************************************************/
+#include "hal_types.h"
+#include "hal_defs.h"
+#include "hal_mcu.h"
+#include "hal_drivers.h"
+#include "hal_uart.h"
+#include "hal_sniffer.h"
+#include "OSAL.h"
+
+#if (defined HAL_SNIFFER) && (HAL_SNIFFER == TRUE)
+
+/***************************************************************************************************
+ *                                             CONSTANTS
+ ***************************************************************************************************/
+#ifndef HAL_SNIFFER_PORT
+#define HAL_SNIFFER_PORT        HAL_UART_PORT_0
+#endif
+
+/* A saturated channel carries ~31 kB/s of frames, which needs more than 460800 baud once framed */
+#ifndef HAL_SNIFFER_BAUD
+#define HAL_SNIFFER_BAUD        HAL_UART_BR_921600
+#endif
+
+/* Ring of records waiting for the UART, a power of 2 */
+#ifndef HAL_SNIFFER_BUF_SIZE
+#define HAL_SNIFFER_BUF_SIZE    1024
+#endif
+
+#if (HAL_SNIFFER_BUF_SIZE & (HAL_SNIFFER_BUF_SIZE - 1))
+#error HAL_SNIFFER_BUF_SIZE must be a power of 2.
+#endif
+
+/* Largest copy handed to HalUARTWrite() when the port cannot send from the ring by DMA */
+#define HAL_SNIFFER_WRITE_MAX   64
+
+/***************************************************************************************************
+ *                                              MACROS
+ ***************************************************************************************************/
+#define HAL_SNIFFER_IDX(x)      ((x) & (HAL_SNIFFER_BUF_SIZE - 1))
+
+/***************************************************************************************************
+ *                                           LOCAL VARIABLES
+ ***************************************************************************************************/
+static uint8 halSnifferBuf[HAL_SNIFFER_BUF_SIZE];
+
+/* Head is only moved by the radio ISR, tail only by the Hal task */
+static uint16 halSnifferHead;
+static uint16 halSnifferTail;
+
+static uint8 halSnifferDrops;
+static bool halSnifferSending;
+
+/***************************************************************************************************
+ *                                            FUNCTIONS - Local
+ ***************************************************************************************************/
+static void halSnifferSent ( uint8 port, uint8 *pBuffer, uint16 length );
+static void halSnifferConsume ( uint16 len );
+
+/***************************************************************************************************
+ *                                            FUNCTIONS - API
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * @fn      HalSnifferInit
+ *
+ * @brief   Open the capture port. Nothing is ever received on it.
+ *
+ * @param   None
+ *
+ * @return  None
+ ***************************************************************************************************/
+void HalSnifferInit (void)
+{
+  halUARTCfg_t uartConfig;
+
+  halSnifferHead = halSnifferTail = 0;
+  halSnifferDrops = 0;
+  halSnifferSending = FALSE;
+
+  uartConfig.configured           = TRUE;
+  uartConfig.baudRate             = HAL_SNIFFER_BAUD;
+  uartConfig.flowControl          = FALSE;
+  uartConfig.flowControlThreshold = 0;
+  uartConfig.rx.maxBufSize        = 0;
+  uartConfig.tx.maxBufSize        = 0;
+  uartConfig.idleTimeout          = 0;
+  uartConfig.intEnable            = TRUE;
+  uartConfig.callBackFunc         = NULL;
+
+  HalUARTOpen(HAL_SNIFFER_PORT, &uartConfig);
+}
+
+/***************************************************************************************************
+ * @fn      HalSnifferFrame
+ *
+ * @brief   Append the record of a received frame to the ring. A record that does not fit is
+ *          dropped and counted in the next one that does.
+ *
+ * @param   pHdr - capture details of the frame
+ *          p1, len1 - first piece of the PSDU
+ *          p2, len2 - rest of the PSDU
+ *
+ * @return  None
+ ***************************************************************************************************/
+void HalSnifferFrame (halSnifferHdr_t *pHdr, uint8 *p1, uint8 len1, uint8 *p2, uint8 len2)
+{
+  uint8 hdr[HAL_SNIFFER_HDR_LEN];
+  uint8 len = HAL_SNIFFER_HDR_LEN + len1 + len2;
+  uint8 fcs = len;
+  uint16 head = halSnifferHead;
+  uint16 tail;
+  halIntState_t his;
+  uint8 i;
+
+  HAL_ENTER_CRITICAL_SECTION(his);
+  tail = halSnifferTail;
+  HAL_EXIT_CRITICAL_SECTION(his);
+
+  /* SOF, LEN and FCS come on top of LEN; one slot always stays free to tell full from empty */
+  if (HAL_SNIFFER_IDX(tail - head - 1) < ((uint16)len + 3))
+  {
+    if (halSnifferDrops < HAL_SNIFFER_DROPS_MAX)
+    {
+      halSnifferDrops++;
+    }
+    return;
+  }
+
+  hdr[0] = BREAK_UINT32(pHdr->backoff, 0);
+  hdr[1] = BREAK_UINT32(pHdr->backoff, 1);
+  hdr[2] = BREAK_UINT32(pHdr->backoff, 2);
+  hdr[3] = BREAK_UINT32(pHdr->backoff, 3);
+  hdr[4] = LO_UINT16(pHdr->timer);
+  hdr[5] = HI_UINT16(pHdr->timer);
+  hdr[6] = pHdr->channel;
+  hdr[7] = (uint8)pHdr->rssi;
+  hdr[8] = pHdr->lqi;
+  hdr[9] = (pHdr->crcOk ? HAL_SNIFFER_FLAG_CRC_OK : 0) | halSnifferDrops;
+
+  halSnifferBuf[head] = HAL_SNIFFER_SOF;
+  head = HAL_SNIFFER_IDX(head + 1);
+  halSnifferBuf[head] = len;
+  head = HAL_SNIFFER_IDX(head + 1);
+
+  for (i = 0; i < HAL_SNIFFER_HDR_LEN; i++)
+  {
+    fcs ^= hdr[i];
+    halSnifferBuf[head] = hdr[i];
+    head = HAL_SNIFFER_IDX(head + 1);
+  }
+  for (i = 0; i < len1; i++)
+  {
+    fcs ^= p1[i];
+    halSnifferBuf[head] = p1[i];
+    head = HAL_SNIFFER_IDX(head + 1);
+  }
+  for (i = 0; i < len2; i++)
+  {
+    fcs ^= p2[i];
+    halSnifferBuf[head] = p2[i];
+    head = HAL_SNIFFER_IDX(head + 1);
+  }
+
+  halSnifferBuf[head] = fcs;
+  head = HAL_SNIFFER_IDX(head + 1);
+
+  HAL_ENTER_CRITICAL_SECTION(his);
+  halSnifferHead = head;
+  HAL_EXIT_CRITICAL_SECTION(his);
+
+  halSnifferDrops = 0;
+  osal_set_event(Hal_TaskID, HAL_SNIFFER_EVENT);
+}
+
+/***************************************************************************************************
+ * @fn      HalSnifferProcess
+ *
+ * @brief   Hand the UART the next contiguous run of the ring. With a DMA port the run is sent in
+ *          place and the tail moves when it has gone out; otherwise it is copied in pieces.
+ *
+ * @param   None
+ *
+ * @return  None
+ ***************************************************************************************************/
+void HalSnifferProcess (void)
+{
+  uint16 head, tail, len;
+  halIntState_t his;
+
+  if (halSnifferSending)
+  {
+    return;
+  }
+
+  HAL_ENTER_CRITICAL_SECTION(his);
+  head = halSnifferHead;
+  HAL_EXIT_CRITICAL_SECTION(his);
+  tail = halSnifferTail;
+
+  if (head == tail)
+  {
+    return;
+  }
+  len = (head > tail) ? (head - tail) : (HAL_SNIFFER_BUF_SIZE - tail);
+
+  if (HalUARTWriteAsync(HAL_SNIFFER_PORT, halSnifferBuf + tail, len, halSnifferSent)
+                                                                           == HAL_UART_SUCCESS)
+  {
+    halSnifferSending = TRUE;
+  }
+  else
+  {
+    halSnifferConsume(HalUARTWrite(HAL_SNIFFER_PORT, halSnifferBuf + tail,
+                                   MIN(len, HAL_SNIFFER_WRITE_MAX)));
+
+    /* Come back once the UART has had time to make room */
+    if (osal_start_timerEx(Hal_TaskID, HAL_SNIFFER_EVENT, 1) != SUCCESS)
+    {
+      osal_set_event(Hal_TaskID, HAL_SNIFFER_EVENT);
+    }
+  }
+}
+
+/***************************************************************************************************
+ * @fn      halSnifferSent
+ *
+ * @brief   The UART has sent a run given to HalUARTWriteAsync(); release it and send the next.
+ *
+ * @param   port, pBuffer - unused
+ *          length - bytes sent
+ *
+ * @return  None
+ ***************************************************************************************************/
+static void halSnifferSent (uint8 port, uint8 *pBuffer, uint16 length)
+{
+  (void)port;
+  (void)pBuffer;
+
+  halSnifferConsume(length);
+  halSnifferSending = FALSE;
+  osal_set_event(Hal_TaskID, HAL_SNIFFER_EVENT);
+}
+
+/***************************************************************************************************
+ * @fn      halSnifferConsume
+ *
+ * @brief   Release bytes at the tail of the ring.
+ *
+ * @param   len - bytes that have been given to the UART
+ *
+ * @return  None
+ ***************************************************************************************************/
+static void halSnifferConsume (uint16 len)
+{
+  halIntState_t his;
+
+  HAL_ENTER_CRITICAL_SECTION(his);
+  halSnifferTail = HAL_SNIFFER_IDX(halSnifferTail + len);
+  HAL_EXIT_CRITICAL_SECTION(his);
+}
+
+#endif /* HAL_SNIFFER */
+
+/***************************************************************************************************
+***************************************************************************************************/
@@ -37,9 +37,1064 @@
   contact Texas Instruments Incorporated at www.TI.com.
 **************************************************************************************************/
 
-/*********************************************************************
- NOTE: Z-Stack and TIMAC no longer use CC2530 Timer 1, Timer 3, and 
-       Timer 4. The supporting timer driver module is removed and left 
-       for the users to implement their own application timer 
-       functions.
-*********************************************************************/
\ No newline at end of file
+/***************************************************************************************************
+ *                                             INCLUDES
+ ***************************************************************************************************/
+#include "hal_mcu.h"
+#include "hal_defs.h"
+#include "hal_types.h"
+#include "hal_timer.h"
+#include "hal_dma.h"
+
+#if (defined HAL_TIMER) && (HAL_TIMER == TRUE)
+
+/***************************************************************************************************
+ *                                             CONSTANTS
+ ***************************************************************************************************/
+
+/* Hardware timers behind the HAL timer IDs. Timer 2 is the MAC timer and is not offered. */
+#define HW_TIMER_1              0x00    /* 16bit, 5 channels - HAL_TIMER_3 */
+#define HW_TIMER_3              0x01    /* 8bit, 2 channels  - HAL_TIMER_0 */
+#define HW_TIMER_4              0x02    /* 8bit, 2 channels  - HAL_TIMER_2 */
+#define HW_TIMER_MAX            3
+#define HW_TIMER_INVALID        0xFF
+
+#define HAL_TIMER_CH_MAX        5       /* Timer 1 */
+#define HAL_TIMER_8BIT_CH_MAX   2       /* Timer 3 and 4 */
+
+/* Timers 1, 3 and 4 run on the 32 MHz tick */
+#define HAL_TIMER_TICKS_PER_US  32
+
+/* T1CTL */
+#define T1CTL_DIV_SHIFT         2       /* /1, /8, /32, /128 */
+#define T1CTL_MODE_FREE         0x01    /* 0x0000 .. 0xFFFF */
+#define T1CTL_MODE_MODULO       0x02    /* 0x0000 .. T1CC0 */
+
+/* T3CTL and T4CTL */
+#define TxCTL_DIV_SHIFT         5       /* /1, /2, /4 .. /128 */
+#define TxCTL_START             0x10
+#define TxCTL_OVFIM             0x08
+#define TxCTL_CLR               0x04
+#define TxCTL_MODE_FREE         0x00    /* 0x00 .. 0xFF */
+#define TxCTL_MODE_MODULO       0x02    /* 0x00 .. TxCC0 */
+
+/* T1CCTLn, T3CCTLn and T4CCTLn */
+#define CCTL_IM                 0x40
+#define CCTL_CMP_SET            0x00
+#define CCTL_CMP_CLEAR          0x08
+#define CCTL_CMP_TOGGLE         0x10
+#define CCTL_CMP_PWM            0x18    /* Set on compare-up, clear on 0 */
+#define CCTL_MODE_COMPARE       0x04
+#define CCTL_CAP_RISE           0x01
+#define CCTL_CAP_FALL           0x02
+#define CCTL_CAP_BOTH           0x03
+
+/* T1STAT, channel flags are BV(channel) */
+#define T1STAT_OVFIF            0x20
+
+/* TIMIF */
+#define TIMIF_T3OVFIF           0x01
+#define TIMIF_T3CH0IF           0x02
+#define TIMIF_T3CH1IF           0x04
+#define TIMIF_T4OVFIF           0x08
+#define TIMIF_T4CH0IF           0x10
+#define TIMIF_T4CH1IF           0x20
+#define TIMIF_T1OVFIM           0x40
+
+/* Flags as returned by halTimerReadFlags(), channel flags are BV(channel) */
+#define HAL_TIMER_FLAG_OVF      0x80
+
+/***************************************************************************************************
+ *                                              MACROS
+ ***************************************************************************************************/
+#define HAL_TIMER_CH_CNT(hwId)  (((hwId) == HW_TIMER_1) ? HAL_TIMER_CH_MAX : HAL_TIMER_8BIT_CH_MAX)
+
+/***************************************************************************************************
+ *                                              TYPEDEFS
+ ***************************************************************************************************/
+typedef struct
+{
+  bool            configured;
+  bool            running;
+  bool            intEnable;
+  bool            overflow;                     /* Report the wrap to the callback */
+  uint8           opMode;
+  uint8           div;                          /* Pre-scaler picked by HalTimerStart() */
+  uint8           chMode[HAL_TIMER_CH_MAX];     /* Channel mode and option, 0 if unused */
+  uint16          top;                          /* Last count before the timer wraps */
+  uint32          base;                         /* Ticks at the last wrap */
+  uint32          capture[HAL_TIMER_CH_MAX];    /* Timestamp of the last Input-Capture */
+  halTimerCBack_t callBackFunc;
+} halTimerSettings_t;
+
+/***************************************************************************************************
+ *                                           LOCAL VARIABLES
+ ***************************************************************************************************/
+static halTimerSettings_t halTimerRecord[HW_TIMER_MAX];
+
+/* Channel ID by channel index, as passed to the callback */
+static const uint8 halTimerChannelId[HAL_TIMER_CH_MAX] =
+{
+  HAL_TIMER_CHANNEL_SINGLE, HAL_TIMER_CHANNEL_A, HAL_TIMER_CHANNEL_B,
+  HAL_TIMER_CHANNEL_C,      HAL_TIMER_CHANNEL_D
+};
+
+/***************************************************************************************************
+ *                                            FUNCTIONS - Local
+ ***************************************************************************************************/
+static uint8 halTimerRemap ( uint8 timerId );
+static uint8 halTimerChIdx ( uint8 hwId, uint8 channel );
+static uint8 halTimerCCTL ( uint8 chMode );
+static void halTimerSetCCTL ( uint8 hwId, uint8 ch, uint8 cctl );
+static void halTimerSetCC ( uint8 hwId, uint8 ch, uint16 count );
+static uint16 halTimerGetCC ( uint8 hwId, uint8 ch );
+static uint16 halTimerGetCount ( uint8 hwId );
+static uint8 halTimerReadFlags ( uint8 hwId );
+static void halTimerSetInt ( uint8 hwId, bool enable );
+static void halTimerProcess ( uint8 hwId );
+
+/***************************************************************************************************
+ *                                            FUNCTIONS - API
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * @fn      HalTimerInit
+ *
+ * @brief   Initialize Timer Service
+ *
+ * @param   None
+ *
+ * @return  None
+ ***************************************************************************************************/
+void HalTimerInit ( void )
+{
+  uint8 hwId;
+
+  for (hwId = 0; hwId < HW_TIMER_MAX; hwId++)
+  {
+    halTimerRecord[hwId].configured = FALSE;
+    halTimerRecord[hwId].running = FALSE;
+    halTimerRecord[hwId].callBackFunc = NULL;
+  }
+}
+
+/***************************************************************************************************
+ * @fn      HalTimerConfig
+ *
+ * @brief   Configure one channel, or the overflow, of a timer. Call once per channel; the
+ *          operation mode, interrupt choice and callback of the last call apply to the whole
+ *          timer. In CTC mode channel SINGLE holds the period, so it cannot capture. Routing a
+ *          channel to its pin (PERCFG, PxSEL) is left to the board code.
+ *
+ * @param   timerId - HAL_TIMER_0 (Timer 3), HAL_TIMER_2 (Timer 4) or HAL_TIMER_3 (Timer 1)
+ *          opMode - HAL_TIMER_MODE_NORMAL (free running) or HAL_TIMER_MODE_CTC (periodic)
+ *          channel - HAL_TIMER_CHANNEL_SINGLE, A .. D; Timers 3 and 4 have SINGLE and A only
+ *          channelMode - Input-Capture, Output-Compare or Overflow, or'ed with a channel option
+ *          intEnable - TRUE to call back from the ISR, FALSE to call back from HalTimerTick()
+ *          cBack - callback function
+ *
+ * @return  Status of the configuration
+ ***************************************************************************************************/
+uint8 HalTimerConfig (uint8 timerId, uint8 opMode, uint8 channel, uint8 channelMode,
+                      bool intEnable, halTimerCBack_t cBack)
+{
+  uint8 hwId = halTimerRemap(timerId);
+  uint8 chMode = channelMode & HAL_TIMER_CH_MODE_MASK;
+  uint8 ch = 0;
+  uint8 idx;
+
+  if (hwId == HW_TIMER_INVALID)
+  {
+    return HAL_TIMER_INVALID_ID;
+  }
+
+#if (defined HAL_ADC_DMA) && (HAL_ADC_DMA == TRUE)
+  if (hwId == HW_TIMER_1)
+  {
+    return HAL_TIMER_IN_USE;
+  }
+#endif
+
+  if ((opMode != HAL_TIMER_MODE_NORMAL) && (opMode != HAL_TIMER_MODE_CTC))
+  {
+    return HAL_TIMER_INVALID_OP_MODE;
+  }
+
+  if ((chMode != HAL_TIMER_CH_MODE_INPUT_CAPTURE) &&
+      (chMode != HAL_TIMER_CH_MODE_OUTPUT_COMPARE) &&
+      (chMode != HAL_TIMER_CH_MODE_OVERFLOW))
+  {
+    return HAL_TIMER_INVALID_CH_MODE;
+  }
+
+  if (chMode != HAL_TIMER_CH_MODE_OVERFLOW)
+  {
+    ch = halTimerChIdx(hwId, channel);
+
+    if ((ch == HW_TIMER_INVALID) ||
+        ((ch == 0) && (opMode == HAL_TIMER_MODE_CTC) && (chMode == HAL_TIMER_CH_MODE_INPUT_CAPTURE)))
+    {
+      return HAL_TIMER_PARAMS_ERROR;
+    }
+  }
+
+  if (halTimerRecord[hwId].running)
+  {
+    return HAL_TIMER_NOT_OK;
+  }
+
+  if (!halTimerRecord[hwId].configured)
+  {
+    for (idx = 0; idx < HAL_TIMER_CH_MAX; idx++)
+    {
+      halTimerRecord[hwId].chMode[idx] = 0;
+    }
+    halTimerRecord[hwId].overflow = FALSE;
+  }
+
+  if (chMode == HAL_TIMER_CH_MODE_OVERFLOW)
+  {
+    halTimerRecord[hwId].overflow = TRUE;
+  }
+  else
+  {
+    halTimerRecord[hwId].chMode[ch] = channelMode;
+  }
+
+  halTimerRecord[hwId].configured = TRUE;
+  halTimerRecord[hwId].opMode = opMode;
+  halTimerRecord[hwId].intEnable = intEnable;
+  halTimerRecord[hwId].callBackFunc = cBack;
+
+  return HAL_TIMER_OK;
+}
+
+/***************************************************************************************************
+ * @fn      HalTimerStart
+ *
+ * @brief   Start a configured timer. The smallest pre-scaler that reaches timePerTick is used, so
+ *          the resolution is as fine as the period allows. In CTC mode the timer wraps every
+ *          timePerTick; in normal mode it runs through its full range. Output-Compare channels
+ *          other than SINGLE in CTC mode fire at the wrap until moved by HalTimerSetCompare().
+ *
+ * @param   timerId - ID of the timer
+ *          timePerTick - period in microseconds; up to 262144 for Timer 1, 1024 for Timers 3 and 4
+ *
+ * @return  Status of the start
+ ***************************************************************************************************/
+uint8 HalTimerStart (uint8 timerId, uint32 timePerTick)
+{
+  uint8 hwId = halTimerRemap(timerId);
+  halTimerSettings_t *pTimer;
+  uint32 ticks = timePerTick * HAL_TIMER_TICKS_PER_US;
+  uint32 range;
+  uint8 divBits = 0;
+  uint8 div = 1;
+  uint8 ch;
+
+  if (hwId == HW_TIMER_INVALID)
+  {
+    return HAL_TIMER_INVALID_ID;
+  }
+
+  pTimer = &halTimerRecord[hwId];
+  if (!pTimer->configured)
+  {
+    return HAL_TIMER_NOT_CONFIGURED;
+  }
+
+  if ((timePerTick == 0) || (timePerTick > (0x0FFFFFFFUL / HAL_TIMER_TICKS_PER_US)))
+  {
+    return HAL_TIMER_PARAMS_ERROR;
+  }
+
+  /* Pick the pre-scaler: Timer 1 steps by 8 then 4 (/1, /8, /32, /128), Timer 3/4 by 2 */
+  range = (hwId == HW_TIMER_1) ? 0x10000UL : 0x100UL;
+  while ((ticks + div - 1) / div > range)
+  {
+    if (div == 128)
+    {
+      return HAL_TIMER_PARAMS_ERROR;
+    }
+
+    div <<= ((hwId == HW_TIMER_1) && (div == 1)) ? 3 : ((hwId == HW_TIMER_1) ? 2 : 1);
+    divBits++;
+  }
+
+  (void)HalTimerStop(timerId);
+
+  pTimer->div = div;
+  pTimer->base = 0;
+  pTimer->top = (pTimer->opMode == HAL_TIMER_MODE_CTC) ?
+                (uint16)(((ticks + div - 1) / div) - 1) : (uint16)(range - 1);
+
+  for (ch = 0; ch < HAL_TIMER_CH_MAX; ch++)
+  {
+    pTimer->capture[ch] = 0;
+
+    if (pTimer->chMode[ch] != 0)
+    {
+      if ((pTimer->chMode[ch] & HAL_TIMER_CH_MODE_OUTPUT_COMPARE) || (ch == 0))
+      {
+        halTimerSetCC(hwId, ch, pTimer->top);
+      }
+      halTimerSetCCTL(hwId, ch, halTimerCCTL(pTimer->chMode[ch]));
+    }
+    else if ((ch == 0) && (pTimer->opMode == HAL_TIMER_MODE_CTC))
+    {
+      /* Channel 0 holds the period without driving its pin */
+      halTimerSetCC(hwId, 0, pTimer->top);
+      halTimerSetCCTL(hwId, 0, CCTL_MODE_COMPARE | CCTL_CMP_SET);
+    }
+  }
+
+  /* Start from zero; the T1CNTL write clears Timer 1 */
+  switch (hwId)
+  {
+  case HW_TIMER_1:
+    T1STAT = 0;
+    T1CNTL = 0;
+    T1CTL = (divBits << T1CTL_DIV_SHIFT) |
+            ((pTimer->opMode == HAL_TIMER_MODE_CTC) ? T1CTL_MODE_MODULO : T1CTL_MODE_FREE);
+    break;
+
+  case HW_TIMER_3:
+    TIMIF = ~(TIMIF_T3OVFIF | TIMIF_T3CH0IF | TIMIF_T3CH1IF);
+    T3CTL = (divBits << TxCTL_DIV_SHIFT) | TxCTL_START | TxCTL_OVFIM | TxCTL_CLR |
+            ((pTimer->opMode == HAL_TIMER_MODE_CTC) ? TxCTL_MODE_MODULO : TxCTL_MODE_FREE);
+    break;
+
+  default:
+    TIMIF = ~(TIMIF_T4OVFIF | TIMIF_T4CH0IF | TIMIF_T4CH1IF);
+    T4CTL = (divBits << TxCTL_DIV_SHIFT) | TxCTL_START | TxCTL_OVFIM | TxCTL_CLR |
+            ((pTimer->opMode == HAL_TIMER_MODE_CTC) ? TxCTL_MODE_MODULO : TxCTL_MODE_FREE);
+    break;
+  }
+
+  pTimer->running = TRUE;
+  halTimerSetInt(hwId, pTimer->intEnable);
+
+  return HAL_TIMER_OK;
+}
+
+/***************************************************************************************************
+ * @fn      HalTimerStop
+ *
+ * @brief   Stop a timer and release its channels
+ *
+ * @param   timerId - ID of the timer
+ *
+ * @return  Status of the stop
+ ***************************************************************************************************/
+uint8 HalTimerStop (uint8 timerId)
+{
+  uint8 hwId = halTimerRemap(timerId);
+  uint8 ch;
+
+  if (hwId == HW_TIMER_INVALID)
+  {
+    return HAL_TIMER_INVALID_ID;
+  }
+
+  if (!halTimerRecord[hwId].running)
+  {
+    return HAL_TIMER_OK;
+  }
+
+  halTimerSetInt(hwId, FALSE);
+
+  switch (hwId)
+  {
+  case HW_TIMER_1:
+    T1CTL = 0;
+    T1STAT = 0;
+    break;
+
+  case HW_TIMER_3:
+    T3CTL = 0;
+    TIMIF = ~(TIMIF_T3OVFIF | TIMIF_T3CH0IF | TIMIF_T3CH1IF);
+    break;
+
+  default:
+    T4CTL = 0;
+    TIMIF = ~(TIMIF_T4OVFIF | TIMIF_T4CH0IF | TIMIF_T4CH1IF);
+    break;
+  }
+
+  for (ch = 0; ch < HAL_TIMER_CH_CNT(hwId); ch++)
+  {
+    halTimerSetCCTL(hwId, ch, 0);
+  }
+
+  halTimerRecord[hwId].running = FALSE;
+
+  return HAL_TIMER_OK;
+}
+
+/***************************************************************************************************
+ * @fn      HalTimerTick
+ *
+ * @brief   Check the timers configured without interrupts, called from Hal_ProcessPoll()
+ *
+ * @param   None
+ *
+ * @return  None
+ ***************************************************************************************************/
+void HalTimerTick (void)
+{
+  uint8 hwId;
+
+  for (hwId = 0; hwId < HW_TIMER_MAX; hwId++)
+  {
+    if (halTimerRecord[hwId].running && !halTimerRecord[hwId].intEnable)
+    {
+      halIntState_t intState;
+
+      HAL_ENTER_CRITICAL_SECTION(intState);
+      halTimerProcess(hwId);
+      HAL_EXIT_CRITICAL_SECTION(intState);
+    }
+  }
+}
+
+/***************************************************************************************************
+ * @fn      HalTimerInterruptEnable
+ *
+ * @brief   Switch a timer between calling back from its ISR and from HalTimerTick(). The events
+ *          share one vector per timer, so channelMode is only checked.
+ *
+ * @param   timerId - ID of the timer
+ *          channelMode - channel mode the caller configured
+ *          enable - TRUE to call back from the ISR
+ *
+ * @return  Status
+ ***************************************************************************************************/
+uint8 HalTimerInterruptEnable (uint8 timerId, uint8 channelMode, bool enable)
+{
+  uint8 hwId = halTimerRemap(timerId);
+
+  if (hwId == HW_TIMER_INVALID)
+  {
+    return HAL_TIMER_INVALID_ID;
+  }
+
+  if ((channelMode & HAL_TIMER_CH_MODE_MASK) == 0)
+  {
+    return HAL_TIMER_INVALID_CH_MODE;
+  }
+
+  halTimerRecord[hwId].intEnable = enable;
+  if (halTimerRecord[hwId].running)
+  {
+    halTimerSetInt(hwId, enable);
+  }
+
+  return HAL_TIMER_OK;
+}
+
+/***************************************************************************************************
+ * @fn      HalTimerSetCompare
+ *
+ * @brief   Move the compare point of an Output-Compare channel of a running timer. In CTC mode
+ *          the channel fires count ticks after each wrap; count must not exceed the period.
+ *
+ * @param   timerId - ID of the timer
+ *          channel - channel ID, not SINGLE in CTC mode
+ *          count - compare value in timer ticks
+ *
+ * @return  Status
+ ***************************************************************************************************/
+uint8 HalTimerSetCompare (uint8 timerId, uint8 channel, uint16 count)
+{
+  uint8 hwId = halTimerRemap(timerId);
+  uint8 ch;
+
+  if (hwId == HW_TIMER_INVALID)
+  {
+    return HAL_TIMER_INVALID_ID;
+  }
+
+  ch = halTimerChIdx(hwId, channel);
+  if ((ch == HW_TIMER_INVALID) ||
+      !(halTimerRecord[hwId].chMode[ch] & HAL_TIMER_CH_MODE_OUTPUT_COMPARE) ||
+      ((ch == 0) && (halTimerRecord[hwId].opMode == HAL_TIMER_MODE_CTC)))
+  {
+    return HAL_TIMER_PARAMS_ERROR;
+  }
+
+  if (!halTimerRecord[hwId].running)
+  {
+    return HAL_TIMER_NOT_CONFIGURED;
+  }
+
+  if (count > halTimerRecord[hwId].top)
+  {
+    return HAL_TIMER_PARAMS_ERROR;
+  }
+
+  halTimerSetCC(hwId, ch, count);
+
+  return HAL_TIMER_OK;
+}
+
+/***************************************************************************************************
+ * @fn      HalTimerCaptureGet
+ *
+ * @brief   Timestamp of the last Input-Capture on a channel, in timer ticks since HalTimerStart().
+ *          The wraps are counted by the timer's own overflow, so a polled timer must be ticked
+ *          at least once per period to keep them.
+ *
+ * @param   timerId - ID of the timer
+ *          channel - channel ID
+ *
+ * @return  Timestamp, 0 if nothing was captured yet
+ ***************************************************************************************************/
+uint32 HalTimerCaptureGet (uint8 timerId, uint8 channel)
+{
+  uint8 hwId = halTimerRemap(timerId);
+  halIntState_t intState;
+  uint32 stamp = 0;
+  uint8 ch;
+
+  if (hwId != HW_TIMER_INVALID)
+  {
+    ch = halTimerChIdx(hwId, channel);
+    if (ch != HW_TIMER_INVALID)
+    {
+      HAL_ENTER_CRITICAL_SECTION(intState);
+      stamp = halTimerRecord[hwId].capture[ch];
+      HAL_EXIT_CRITICAL_SECTION(intState);
+    }
+  }
+
+  return stamp;
+}
+
+/***************************************************************************************************
+ * @fn      HalTimerNow
+ *
+ * @brief   Current time in timer ticks since HalTimerStart()
+ *
+ * @param   timerId - ID of the timer
+ *
+ * @return  Timer ticks, 0 if the timer is not running
+ ***************************************************************************************************/
+uint32 HalTimerNow (uint8 timerId)
+{
+  uint8 hwId = halTimerRemap(timerId);
+  halIntState_t intState;
+  uint32 now = 0;
+  uint16 count;
+
+  if ((hwId != HW_TIMER_INVALID) && halTimerRecord[hwId].running)
+  {
+    HAL_ENTER_CRITICAL_SECTION(intState);
+
+    count = halTimerGetCount(hwId);
+    now = halTimerRecord[hwId].base + count;
+
+    /* A wrap not yet serviced: a low count is from after it */
+    if ((halTimerReadFlags(hwId) & HAL_TIMER_FLAG_OVF) && (count < (halTimerRecord[hwId].top / 2)))
+    {
+      now += (uint32)halTimerRecord[hwId].top + 1;
+    }
+
+    HAL_EXIT_CRITICAL_SECTION(intState);
+  }
+
+  return now;
+}
+
+/***************************************************************************************************
+ * @fn      HalTimerTickDiv
+ *
+ * @brief   Pre-scaler picked by HalTimerStart(); a timer tick lasts div/32 microseconds
+ *
+ * @param   timerId - ID of the timer
+ *
+ * @return  Pre-scaler, 0 if the timer is not running
+ ***************************************************************************************************/
+uint8 HalTimerTickDiv (uint8 timerId)
+{
+  uint8 hwId = halTimerRemap(timerId);
+
+  if ((hwId == HW_TIMER_INVALID) || !halTimerRecord[hwId].running)
+  {
+    return 0;
+  }
+
+  return halTimerRecord[hwId].div;
+}
+
+/***************************************************************************************************
+ * @fn      HalTimerDmaTrigger
+ *
+ * @brief   DMA trigger raised by the compare event of a channel, so a DMA channel armed on it is
+ *          paced by the timer. Timer 1 channels C and D have no DMA trigger.
+ *
+ * @param   timerId - ID of the timer
+ *          channel - channel ID
+ *
+ * @return  HAL_DMA_TRIG_xxx, HAL_DMA_TRIG_NONE if there is none
+ ***************************************************************************************************/
+uint8 HalTimerDmaTrigger (uint8 timerId, uint8 channel)
+{
+#if (defined HAL_DMA) && (HAL_DMA == TRUE)
+  uint8 hwId = halTimerRemap(timerId);
+  uint8 ch;
+
+  if (hwId == HW_TIMER_INVALID)
+  {
+    return HAL_DMA_TRIG_NONE;
+  }
+
+  ch = halTimerChIdx(hwId, channel);
+  if (ch == HW_TIMER_INVALID)
+  {
+    return HAL_DMA_TRIG_NONE;
+  }
+
+  switch (hwId)
+  {
+  case HW_TIMER_1:
+    return (ch <= 2) ? (HAL_DMA_TRIG_T1_CH0 + ch) : HAL_DMA_TRIG_NONE;
+
+  case HW_TIMER_3:
+    return HAL_DMA_TRIG_T3_CH0 + ch;
+
+  default:
+    return HAL_DMA_TRIG_T4_CH0 + ch;
+  }
+#else
+  (void)timerId;
+  (void)channel;
+  return 0;
+#endif
+}
+
+/***************************************************************************************************
+ * @fn      HalTimerBusy
+ *
+ * @brief   Timers 1, 3 and 4 stop in PM2/3, so halSleep() stays awake while one is running
+ *
+ * @param   None
+ *
+ * @return  TRUE if a timer is running
+ ***************************************************************************************************/
+bool HalTimerBusy (void)
+{
+  return (halTimerRecord[HW_TIMER_1].running || halTimerRecord[HW_TIMER_3].running ||
+          halTimerRecord[HW_TIMER_4].running);
+}
+
+/***************************************************************************************************
+ *                                            FUNCTIONS - Local
+ ***************************************************************************************************/
+
+/***************************************************************************************************
+ * @fn      halTimerRemap
+ *
+ * @brief   Map a HAL timer ID to the hardware timer
+ *
+ * @param   timerId - ID of the timer
+ *
+ * @return  HW_TIMER_xxx, HW_TIMER_INVALID for the MAC timer or an unknown ID
+ ***************************************************************************************************/
+static uint8 halTimerRemap (uint8 timerId)
+{
+  switch (timerId)
+  {
+  case HAL_TIMER_0:
+    return HW_TIMER_3;
+
+  case HAL_TIMER_2:
+    return HW_TIMER_4;
+
+  case HAL_TIMER_3:
+    return HW_TIMER_1;
+
+  default:
+    return HW_TIMER_INVALID;
+  }
+}
+
+/***************************************************************************************************
+ * @fn      halTimerChIdx
+ *
+ * @brief   Map a channel ID to the channel index of a hardware timer
+ *
+ * @param   hwId - hardware timer
+ *          channel - channel ID
+ *
+ * @return  Channel index, HW_TIMER_INVALID if the timer does not have the channel
+ ***************************************************************************************************/
+static uint8 halTimerChIdx (uint8 hwId, uint8 channel)
+{
+  uint8 ch;
+
+  for (ch = 0; ch < HAL_TIMER_CH_CNT(hwId); ch++)
+  {
+    if (channel == halTimerChannelId[ch])
+    {
+      return ch;
+    }
+  }
+
+  return HW_TIMER_INVALID;
+}
+
+/***************************************************************************************************
+ * @fn      halTimerCCTL
+ *
+ * @brief   Capture/compare control value for a channel mode; the IM bit is set separately
+ *
+ * @param   chMode - channel mode and option
+ *
+ * @return  TxCCTLn value
+ ***************************************************************************************************/
+static uint8 halTimerCCTL (uint8 chMode)
+{
+  uint8 opt = chMode & HAL_TIMER_CH_OPT_MASK;
+
+  if (chMode & HAL_TIMER_CH_MODE_INPUT_CAPTURE)
+  {
+    return (opt == HAL_TIMER_CH_CAPTURE_FALL) ? CCTL_CAP_FALL :
+           (opt == HAL_TIMER_CH_CAPTURE_BOTH) ? CCTL_CAP_BOTH : CCTL_CAP_RISE;
+  }
+
+  return CCTL_MODE_COMPARE | ((opt == HAL_TIMER_CH_COMPARE_SET)   ? CCTL_CMP_SET :
+                              (opt == HAL_TIMER_CH_COMPARE_CLEAR) ? CCTL_CMP_CLEAR :
+                              (opt == HAL_TIMER_CH_COMPARE_PWM)   ? CCTL_CMP_PWM : CCTL_CMP_TOGGLE);
+}
+
+/***************************************************************************************************
+ * @fn      halTimerSetCCTL
+ *
+ * @brief   Write the capture/compare control register of a channel
+ *
+ * @param   hwId - hardware timer
+ *          ch - channel index
+ *          cctl - register value
+ *
+ * @return  None
+ ***************************************************************************************************/
+static void halTimerSetCCTL (uint8 hwId, uint8 ch, uint8 cctl)
+{
+  if (hwId == HW_TIMER_1)
+  {
+    switch (ch)
+    {
+    case 0:  T1CCTL0 = cctl;  break;
+    case 1:  T1CCTL1 = cctl;  break;
+    case 2:  T1CCTL2 = cctl;  break;
+    case 3:  T1CCTL3 = cctl;  break;
+    default: T1CCTL4 = cctl;  break;
+    }
+  }
+  else if (hwId == HW_TIMER_3)
+  {
+    if (ch == 0)  T3CCTL0 = cctl;  else  T3CCTL1 = cctl;
+  }
+  else
+  {
+    if (ch == 0)  T4CCTL0 = cctl;  else  T4CCTL1 = cctl;
+  }
+}
+
+/***************************************************************************************************
+ * @fn      halTimerSetCC
+ *
+ * @brief   Write the capture/compare register of a channel; low byte first on Timer 1
+ *
+ * @param   hwId - hardware timer
+ *          ch - channel index
+ *          count - compare value
+ *
+ * @return  None
+ ***************************************************************************************************/
+static void halTimerSetCC (uint8 hwId, uint8 ch, uint16 count)
+{
+  uint8 lo = LO_UINT16(count);
+  uint8 hi = HI_UINT16(count);
+
+  if (hwId == HW_TIMER_1)
+  {
+    switch (ch)
+    {
+    case 0:  T1CC0L = lo;  T1CC0H = hi;  break;
+    case 1:  T1CC1L = lo;  T1CC1H = hi;  break;
+    case 2:  T1CC2L = lo;  T1CC2H = hi;  break;
+    case 3:  T1CC3L = lo;  T1CC3H = hi;  break;
+    default: T1CC4L = lo;  T1CC4H = hi;  break;
+    }
+  }
+  else if (hwId == HW_TIMER_3)
+  {
+    if (ch == 0)  T3CC0 = lo;  else  T3CC1 = lo;
+  }
+  else
+  {
+    if (ch == 0)  T4CC0 = lo;  else  T4CC1 = lo;
+  }
+}
+
+/***************************************************************************************************
+ * @fn      halTimerGetCC
+ *
+ * @brief   Read the capture/compare register of a channel; low byte first on Timer 1
+ *
+ * @param   hwId - hardware timer
+ *          ch - channel index
+ *
+ * @return  Register value
+ ***************************************************************************************************/
+static uint16 halTimerGetCC (uint8 hwId, uint8 ch)
+{
+  uint8 lo;
+  uint8 hi = 0;
+
+  if (hwId == HW_TIMER_1)
+  {
+    switch (ch)
+    {
+    case 0:  lo = T1CC0L;  hi = T1CC0H;  break;
+    case 1:  lo = T1CC1L;  hi = T1CC1H;  break;
+    case 2:  lo = T1CC2L;  hi = T1CC2H;  break;
+    case 3:  lo = T1CC3L;  hi = T1CC3H;  break;
+    default: lo = T1CC4L;  hi = T1CC4H;  break;
+    }
+  }
+  else if (hwId == HW_TIMER_3)
+  {
+    lo = (ch == 0) ? T3CC0 : T3CC1;
+  }
+  else
+  {
+    lo = (ch == 0) ? T4CC0 : T4CC1;
+  }
+
+  return BUILD_UINT16(lo, hi);
+}
+
+/***************************************************************************************************
+ * @fn      halTimerGetCount
+ *
+ * @brief   Read the counter; T1CNTL must be read first to latch T1CNTH
+ *
+ * @param   hwId - hardware timer
+ *
+ * @return  Counter value
+ ***************************************************************************************************/
+static uint16 halTimerGetCount (uint8 hwId)
+{
+  uint8 lo;
+
+  if (hwId == HW_TIMER_1)
+  {
+    lo = T1CNTL;
+    return BUILD_UINT16(lo, T1CNTH);
+  }
+
+  return (hwId == HW_TIMER_3) ? T3CNT : T4CNT;
+}
+
+/***************************************************************************************************
+ * @fn      halTimerReadFlags
+ *
+ * @brief   Read the pending events of a timer
+ *
+ * @param   hwId - hardware timer
+ *
+ * @return  BV(channel) per channel event, HAL_TIMER_FLAG_OVF for the wrap
+ ***************************************************************************************************/
+static uint8 halTimerReadFlags (uint8 hwId)
+{
+  uint8 flags;
+  uint8 timif = TIMIF;
+
+  if (hwId == HW_TIMER_1)
+  {
+    flags = T1STAT;
+    return (flags & 0x1F) | ((flags & T1STAT_OVFIF) ? HAL_TIMER_FLAG_OVF : 0);
+  }
+
+  if (hwId == HW_TIMER_3)
+  {
+    return ((timif & TIMIF_T3CH0IF) ? BV(0) : 0) | ((timif & TIMIF_T3CH1IF) ? BV(1) : 0) |
+           ((timif & TIMIF_T3OVFIF) ? HAL_TIMER_FLAG_OVF : 0);
+  }
+
+  return ((timif & TIMIF_T4CH0IF) ? BV(0) : 0) | ((timif & TIMIF_T4CH1IF) ? BV(1) : 0) |
+         ((timif & TIMIF_T4OVFIF) ? HAL_TIMER_FLAG_OVF : 0);
+}
+
+/***************************************************************************************************
+ * @fn      halTimerSetInt
+ *
+ * @brief   Enable or disable the interrupts of a running timer. The wrap interrupt stays on for
+ *          Input-Capture, which needs it to timestamp.
+ *
+ * @param   hwId - hardware timer
+ *          enable - TRUE to enable
+ *
+ * @return  None
+ ***************************************************************************************************/
+static void halTimerSetInt (uint8 hwId, bool enable)
+{
+  halTimerSettings_t *pTimer = &halTimerRecord[hwId];
+  uint8 ch;
+
+  for (ch = 0; ch < HAL_TIMER_CH_CNT(hwId); ch++)
+  {
+    if (pTimer->chMode[ch] != 0)
+    {
+      halTimerSetCCTL(hwId, ch, halTimerCCTL(pTimer->chMode[ch]) | (enable ? CCTL_IM : 0));
+    }
+  }
+
+  /* TIMIF.T1OVFIM is left at its reset value of 1, see halTimerProcess() */
+  switch (hwId)
+  {
+  case HW_TIMER_1:
+    T1IE = enable;
+    break;
+
+  case HW_TIMER_3:
+    T3IE = enable;
+    break;
+
+  default:
+    T4IE = enable;
+    break;
+  }
+}
+
+/***************************************************************************************************
+ * @fn      halTimerProcess
+ *
+ * @brief   Service the pending events of a timer: timestamp captures, count the wrap and call
+ *          back. Must be called with interrupts disabled or from the timer ISR.
+ *
+ * @param   hwId - hardware timer
+ *
+ * @return  None
+ ***************************************************************************************************/
+static void halTimerProcess (uint8 hwId)
+{
+  halTimerSettings_t *pTimer = &halTimerRecord[hwId];
+  uint8 timerId = (hwId == HW_TIMER_1) ? HAL_TIMER_3 :
+                  ((hwId == HW_TIMER_3) ? HAL_TIMER_0 : HAL_TIMER_2);
+  uint32 period = (uint32)pTimer->top + 1;
+  uint8 flags = halTimerReadFlags(hwId);
+  uint8 ch;
+
+  /* Flags are cleared by writing 0, writing 1 has no effect and keeps TIMIF.T1OVFIM set */
+  if (hwId == HW_TIMER_1)
+  {
+    T1STAT = ~((flags & 0x1F) | ((flags & HAL_TIMER_FLAG_OVF) ? T1STAT_OVFIF : 0));
+  }
+  else if (hwId == HW_TIMER_3)
+  {
+    TIMIF = ~(((flags & BV(0)) ? TIMIF_T3CH0IF : 0) | ((flags & BV(1)) ? TIMIF_T3CH1IF : 0) |
+              ((flags & HAL_TIMER_FLAG_OVF) ? TIMIF_T3OVFIF : 0));
+  }
+  else
+  {
+    TIMIF = ~(((flags & BV(0)) ? TIMIF_T4CH0IF : 0) | ((flags & BV(1)) ? TIMIF_T4CH1IF : 0) |
+              ((flags & HAL_TIMER_FLAG_OVF) ? TIMIF_T4OVFIF : 0));
+  }
+
+  for (ch = 0; ch < HAL_TIMER_CH_CNT(hwId); ch++)
+  {
+    if ((flags & BV(ch)) && (pTimer->chMode[ch] != 0))
+    {
+      if (pTimer->chMode[ch] & HAL_TIMER_CH_MODE_INPUT_CAPTURE)
+      {
+        uint16 cap = halTimerGetCC(hwId, ch);
+
+        pTimer->capture[ch] = pTimer->base + cap;
+
+        /* With the wrap pending too, a low capture is from after it */
+        if ((flags & HAL_TIMER_FLAG_OVF) && (cap < (pTimer->top / 2)))
+        {
+          pTimer->capture[ch] += period;
+        }
+      }
+
+      if (pTimer->callBackFunc)
+      {
+        (pTimer->callBackFunc)(timerId, halTimerChannelId[ch],
+                               pTimer->chMode[ch] & HAL_TIMER_CH_MODE_MASK);
+      }
+    }
+  }
+
+  if (flags & HAL_TIMER_FLAG_OVF)
+  {
+    pTimer->base += period;
+
+    if (pTimer->overflow && pTimer->callBackFunc)
+    {
+      (pTimer->callBackFunc)(timerId, HAL_TIMER_CHANNEL_SINGLE, HAL_TIMER_CH_MODE_OVERFLOW);
+    }
+  }
+}
+
+/***************************************************************************************************
+ *                                    INTERRUPT SERVICE ROUTINES
+ ***************************************************************************************************/
+
+#if !((defined HAL_ADC_DMA) && (HAL_ADC_DMA == TRUE))
+/***************************************************************************************************
+ * @fn      halTimer1Isr
+ *
+ * @brief   Timer 1 ISR
+ *
+ * @param
+ *
+ * @return
+ ***************************************************************************************************/
+HAL_ISR_FUNCTION( halTimer1Isr, T1_VECTOR )
+{
+  HAL_ENTER_ISR();
+  halTimerProcess(HW_TIMER_1);
+  HAL_EXIT_ISR();
+}
+#endif
+
+/***************************************************************************************************
+ * @fn      halTimer3Isr
+ *
+ * @brief   Timer 3 ISR
+ *
+ * @param
+ *
+ * @return
+ ***************************************************************************************************/
+HAL_ISR_FUNCTION( halTimer3Isr, T3_VECTOR )
+{
+  HAL_ENTER_ISR();
+  halTimerProcess(HW_TIMER_3);
+  HAL_EXIT_ISR();
+}
+
+/***************************************************************************************************
+ * @fn      halTimer4Isr
+ *
+ * @brief   Timer 4 ISR
+ *
+ * @param
+ *
+ * @return
+ ***************************************************************************************************/
+HAL_ISR_FUNCTION( halTimer4Isr, T4_VECTOR )
+{
+  HAL_ENTER_ISR();
+  halTimerProcess(HW_TIMER_4);
+  HAL_EXIT_ISR();
+}
+
+#endif /* HAL_TIMER */
+
+/***************************************************************************************************
+***************************************************************************************************/
@@ -215,6 +215,36 @@ uint16 HalUARTWrite(uint8 port, uint8 *buf, uint16 len)
 #endif
 }
 
+/******************************************************************************
+ * @fn      HalUARTWriteAsync
+ *
+ * @brief   Queue a buffer to be sent by the UART TX DMA straight from the caller's memory.
+ *
+ * @param   port - UART port
+ *          buf  - pointer to the buffer that will be written, owned by the caller until txCB
+ *          len  - length of the buffer, in bytes
+ *          txCB - invoked from HalUARTPoll() once the buffer has been sent, may be NULL
+ *
+ * @return  HAL_UART_SUCCESS if queued, HAL_UART_MEM_FAIL if the port cannot take it now,
+ *          or HAL_UART_NOT_SUPPORTED if the port is not driven by DMA
+ *****************************************************************************/
+uint8 HalUARTWriteAsync(uint8 port, uint8 *buf, uint16 len, halUARTTxCBack_t txCB)
+{
+  (void)port;
+  (void)buf;
+  (void)len;
+  (void)txCB;
+
+#if (HAL_UART_DMA == 1)
+  if (port == HAL_UART_PORT_0)  return HalUARTWriteAsyncDMA(buf, len, txCB);
+#endif
+#if (HAL_UART_DMA == 2)
+  if (port == HAL_UART_PORT_1)  return HalUARTWriteAsyncDMA(buf, len, txCB);
+#endif
+
+  return HAL_UART_NOT_SUPPORTED;
+}
+
 /******************************************************************************
  * @fn      HalUARTSuspend
  *
@@ -264,7 +294,7 @@ void HalUARTResume( void )
  *****************************************************************************/
 void HalUARTPoll(void)
 {
-#if HAL_UART_DMA
+#if HAL_UART_DMA && !HAL_UART_DMA_EVT
   HalUARTPollDMA();
 #endif
 #if HAL_UART_ISR
@@ -275,6 +305,22 @@ void HalUARTPoll(void)
 #endif
 }
 
+/***************************************************************************************************
+ * @fn      HalUARTProcessEvent
+ *
+ * @brief   Service the UARTs that are driven by HAL_UART_EVENT instead of HalUARTPoll().
+ *
+ * @param   none
+ *
+ * @return  none
+ *****************************************************************************/
+void HalUARTProcessEvent(void)
+{
+#if HAL_UART_DMA_EVT
+  HalUARTPollDMA();
+#endif
+}
+
 /**************************************************************************************************
  * @fn      Hal_UART_RxBufLen()
  *
@@ -61,6 +61,20 @@
 #define MAC_SRCMATCH_EXT_MAX_NUM_ENTRIES     12
 
 #define MAC_SRCMATCH_ENABLE_BITMAP_LEN       3
+
+/* Both layouts occupy the same 96 bytes of radio RAM */
+#define MAC_SRCMATCH_TABLE_SIZE              ( MAC_SRCMATCH_SHORT_MAX_NUM_ENTRIES * \
+                                               MAC_SRCMATCH_SHORT_ENTRY_SIZE )
+
+/* Number of buckets in the shadow hash index. Must be a power of 2 */
+#define MAC_SRCMATCH_HASH_SIZE               16
+
+#define MAC_SRCMATCH_ENTRY_SIZE()            ( ( macSrcMatchAddrMode == SADDR_MODE_SHORT ) ? \
+                                               MAC_SRCMATCH_SHORT_ENTRY_SIZE : MAC_SRCMATCH_EXT_ENTRY_SIZE )
+
+/* Extended address entries use every other bit of the enable bitmaps */
+#define MAC_SRCMATCH_EN_BIT(index)           ( (uint24)0x01 << ( ( macSrcMatchAddrMode == SADDR_MODE_SHORT ) ? \
+                                               (index) : ( (index) * 2 ) ) )
           
 /* ------------------------------------------------------------------------------------------------
  *                                      Global Variables
@@ -81,15 +95,33 @@ uint8 macSrcMatchMaxNumEntries = 0;
 uint8 macSrcMatchAddrMode = SADDR_MODE_SHORT;  
 bool macSrcMatchIsAckAllPending = FALSE;
 
+/*
+ RAM shadow of the source address table, rebuilt in MAC_SrcMatchEnable() and
+ kept in step with the radio by MAC_SrcMatchAddEntry()/MAC_SrcMatchDeleteEntry().
+ macSrcMatchShadowTbl has the radio RAM layout and macSrcMatchShadowEn is an
+ image of the SRC*EN register, so lookups never read back from the radio.
+ Entries in use are chained off macSrcMatchHashHead[] by address hash, unused
+ entries are chained off macSrcMatchFreeHead, both through macSrcMatchNext[].
+ */
+static uint8  macSrcMatchShadowTbl[MAC_SRCMATCH_TABLE_SIZE];
+static uint24 macSrcMatchShadowEn;
+static uint8  macSrcMatchHashHead[MAC_SRCMATCH_HASH_SIZE];
+static uint8  macSrcMatchNext[MAC_SRCMATCH_SHORT_MAX_NUM_ENTRIES];
+static uint8  macSrcMatchFreeHead = MAC_SRCMATCH_INVALID_INDEX;
+
 /* ------------------------------------------------------------------------------------------------
  *                                         Local Functions
  * ------------------------------------------------------------------------------------------------
  */
 static uint8 macSrcMatchFindEmptyEntry( void );
-static uint8 macSrcMatchCheckSrcAddr ( sAddr_t *addr, uint16 panID  );
+static uint8 *macSrcMatchBuildEntry( sAddr_t *addr, uint16 panID, uint8 *entry );
+static uint8 macSrcMatchCheckSrcAddr ( uint8 *pEntry, uint8 entrySize );
+static uint8 macSrcMatchHash( uint8 *pEntry, uint8 entrySize );
+static void macSrcMatchShadowLoad( void );
+static void macSrcMatchShadowAdd( uint8 index, uint8 *pEntry, uint8 entrySize );
+static void macSrcMatchShadowDelete( uint8 index, uint8 entrySize );
 static void macSrcMatchSetPendEnBit( uint8 index );
 static void macSrcMatchSetEnableBit( uint8 index, bool option );
-static bool macSrcMatchCheckEnableBit( uint8 index );
 static uint24 macSrcMatchGetEnableBit( void );
 static uint24 macSrcMatchGetPendEnBit( void );
 
@@ -149,6 +181,9 @@ uint8 MAC_SrcMatchEnable ( uint8 addrType, uint8 num  )
   macSrcMatchMaxNumEntries = num;
   macSrcMatchAddrMode = addrType;           
 
+  /* Rebuild the shadow from whatever the radio table already holds */
+  macSrcMatchShadowLoad();
+
   return rtn;
 }
 
@@ -171,6 +206,8 @@ uint8 MAC_SrcMatchEnable ( uint8 addrType, uint8 num  )
 uint8 MAC_SrcMatchAddEntry ( sAddr_t *addr, uint16 panID )
 {
   uint8 index;
+  uint8 *pAddr;
+  uint8 entrySize;
   uint8 entry[MAC_SRCMATCH_SHORT_ENTRY_SIZE];
   
   /* Check if the input parameters are valid */
@@ -179,8 +216,11 @@ uint8 MAC_SrcMatchAddEntry ( sAddr_t *addr, uint16 panID )
     return MAC_INVALID_PARAMETER;  
   }
   
+  pAddr = macSrcMatchBuildEntry( addr, panID, entry );
+  entrySize = MAC_SRCMATCH_ENTRY_SIZE();
+  
   /* Check if the entry already exists. Do not add duplicated entry */
-  if ( macSrcMatchCheckSrcAddr( addr, panID ) != MAC_SRCMATCH_INVALID_INDEX )
+  if ( macSrcMatchCheckSrcAddr( pAddr, entrySize ) != MAC_SRCMATCH_INVALID_INDEX )
   {
     return MAC_DUPLICATED_ENTRY; 
   }
@@ -194,27 +234,19 @@ uint8 MAC_SrcMatchAddEntry ( sAddr_t *addr, uint16 panID )
     return MAC_NO_RESOURCES;   /* Table is full */
   }
   
-  if ( macSrcMatchAddrMode == SADDR_MODE_SHORT )
-  {
-    /* Write the PanID and short address */
-    entry[0] = LO_UINT16( panID );  /* Little Endian for the radio RAM */
-    entry[1] = HI_UINT16( panID );
-    entry[2] = LO_UINT16( addr->addr.shortAddr );
-    entry[3] = HI_UINT16( addr->addr.shortAddr );
-    MAC_RADIO_SRC_MATCH_TABLE_WRITE( ( index * MAC_SRCMATCH_SHORT_ENTRY_SIZE ), 
-                   entry, MAC_SRCMATCH_SHORT_ENTRY_SIZE );
-  }
-  else
-  {
-    /* Write the extended address */
-    MAC_RADIO_SRC_MATCH_TABLE_WRITE( ( index * MAC_SRCMATCH_EXT_ENTRY_SIZE ), 
-                   addr->addr.extAddr, MAC_SRCMATCH_EXT_ENTRY_SIZE ); 
-  }
+  /* 
+   Write the PanID and short address, or the extended address. The enable bit
+   of a free entry is clear, so the radio does not match on it half written.
+  */
+  MAC_RADIO_SRC_MATCH_TABLE_WRITE( ( index * entrySize ), pAddr, entrySize );
   
   /* Set the Autopend enable bits */
   macSrcMatchSetPendEnBit( index );
   
-  /* Set the Src Match enable bits */
+  /* Record the entry in the shadow index */
+  macSrcMatchShadowAdd( index, pAddr, entrySize );
+  
+  /* Set the Src Match enable bits last, once the entry is complete */
   macSrcMatchSetEnableBit( index, TRUE );
   
   return MAC_SUCCESS;
@@ -238,22 +270,33 @@ uint8 MAC_SrcMatchAddEntry ( sAddr_t *addr, uint16 panID )
 uint8 MAC_SrcMatchDeleteEntry ( sAddr_t *addr, uint16 panID  )
 {
   uint8 index;
+  uint8 *pAddr;
+  uint8 entrySize;
+  uint8 entry[MAC_SRCMATCH_SHORT_ENTRY_SIZE];
   
   if ( addr == NULL || addr->addrMode != macSrcMatchAddrMode )
   {
     return MAC_INVALID_PARAMETER;  
   }
   
+  pAddr = macSrcMatchBuildEntry( addr, panID, entry );
+  entrySize = MAC_SRCMATCH_ENTRY_SIZE();
+  
   /* Look up the source address table and find the entry. */
-  index = macSrcMatchCheckSrcAddr( addr, panID );
+  index = macSrcMatchCheckSrcAddr( pAddr, entrySize );
 
   if( index == MAC_SRCMATCH_INVALID_INDEX )
   {
     return MAC_INVALID_PARAMETER; 
   }
   
-  /* Clear Src Match enable bits */
+  /* 
+   Clear Src Match enable bits first so the radio stops matching the entry 
+   before it is handed back to the free list and can be rewritten.
+  */
   macSrcMatchSetEnableBit( index, FALSE );
+  
+  macSrcMatchShadowDelete( index, entrySize );
 
   return MAC_SUCCESS;
 }
@@ -336,108 +379,202 @@ MAC_INTERNAL_API bool MAC_SrcMatchCheckResult( void )
 /*********************************************************************
  * @fn          macSrcMatchFindEmptyEntry
  *
- * @brief       return index of the first empty entry found
+ * @brief       return index of an empty entry, taken from the head of the
+ *              shadow free list
  *
  * @param       none
  *
- * @return      uint8 - return index of the first empty entry found
+ * @return      uint8 - index of an empty entry, or macSrcMatchMaxNumEntries
+ *                      if the table is full
  */
 static uint8 macSrcMatchFindEmptyEntry( void )
 {
-  uint8  index;
-  uint24 enable;
-     
-  enable = MAC_RADIO_SRC_MATCH_GET_EN();
-        
-  if( macSrcMatchAddrMode == SADDR_MODE_SHORT )
+  if( macSrcMatchFreeHead == MAC_SRCMATCH_INVALID_INDEX )
   {
-    for( index = 0; index < macSrcMatchMaxNumEntries; index++ )
-    {  
-      if( ( enable & ( (uint24)0x01 << index ) ) == 0 )
-      {
-        return index;
-      }
-    }
+    /* The table is full */
+    return macSrcMatchMaxNumEntries;
   }
-  else
+  
+  return macSrcMatchFreeHead;
+}
+
+/*********************************************************************
+ * @fn          macSrcMatchBuildEntry
+ *
+ * @brief       Build the source address table entry for an address, in the
+ *              format used by the radio RAM
+ *
+ * @param       addr - a pointer to sAddr_t which contains addrMode 
+ *                     and a union of a short 16-bit MAC address or an extended 
+ *                     64-bit MAC address
+ * @param       panID - the device PAN ID. It is only used when the addr is 
+ *                      using short address 
+ * @param       entry - buffer of MAC_SRCMATCH_SHORT_ENTRY_SIZE bytes for
+ *                      the short address entry
+ *
+ * @return      uint8* - pointer to the entry of MAC_SRCMATCH_ENTRY_SIZE() bytes
+ */
+static uint8 *macSrcMatchBuildEntry( sAddr_t *addr, uint16 panID, uint8 *entry )
+{
+  if( macSrcMatchAddrMode == SADDR_MODE_SHORT )
   {
-    for( index = 0; index < macSrcMatchMaxNumEntries; index++ )
-    {  
-      if( ( enable & ( (uint24)0x01 << ( index * 2 ) ) ) == 0 )
-      {
-        return index;
-      }
-    }
+    entry[0] = LO_UINT16( panID );  /* Little Endian for the radio RAM */
+    entry[1] = HI_UINT16( panID );
+    entry[2] = LO_UINT16( addr->addr.shortAddr );
+    entry[3] = HI_UINT16( addr->addr.shortAddr );
+    return entry;
   }
   
-  /* 
-   The value of index shall be macSrcMatchMaxNumEntries when it executes
-   here. The table is full.
-  */
-  return index;
+  return addr->addr.extAddr;
 }
 
 /*********************************************************************
  * @fn         macSrcMatchCheckSrcAddr
  *
- * @brief      Check if a short or extended address is in the source address table.
- *             This function shall not be called from ISR. It is not thread safe.
+ * @brief      Check if an entry is in the source address table. Only the hash
+ *             chain of the entry is searched, and it is compared against the
+ *             shadow rather than the radio RAM. This function shall not be 
+ *             called from ISR. It is not thread safe.
+ *
+ * @param      pEntry - entry built by macSrcMatchBuildEntry()
+ * @param      entrySize - MAC_SRCMATCH_SHORT_ENTRY_SIZE or MAC_SRCMATCH_EXT_ENTRY_SIZE
  *
- * @param      addr - a pointer to sAddr_t which contains addrMode 
- *                    and a union of a short 16-bit MAC address or an extended 
- *                    64-bit MAC address to be checked in the source address table. 
- * @param      panID - the device PAN ID. It is only used when the addr is 
- *                     using short address 
-
  * @return     uint8 - index of the entry in the table. Return 
  *                     MAC_SRCMATCH_INVALID_INDEX (0xFF) if address not found.
  */
-static uint8 macSrcMatchCheckSrcAddr ( sAddr_t *addr, uint16 panID  )
+static uint8 macSrcMatchCheckSrcAddr ( uint8 *pEntry, uint8 entrySize )
 {
   uint8 index;     
-  uint8 *pAddr;
-  uint8 entrySize;
-  uint8 entry[MAC_SRCMATCH_SHORT_ENTRY_SIZE];  
-  uint8 ramEntry[MAC_SRCMATCH_EXT_ENTRY_SIZE];
-      
-  /*
-   Currently, shadow memory is not supported to optimize SPI traffic.
-  */
   
-  if( macSrcMatchAddrMode == SADDR_MODE_SHORT )
+  index = macSrcMatchHashHead[macSrcMatchHash( pEntry, entrySize )];
+  
+  while( index != MAC_SRCMATCH_INVALID_INDEX )
   {
-    entry[0] = LO_UINT16( panID );  /* Little Endian for the radio RAM */
-    entry[1] = HI_UINT16( panID );
-    entry[2] = LO_UINT16( addr->addr.shortAddr );
-    entry[3] = HI_UINT16( addr->addr.shortAddr );
-    pAddr = entry;
-    entrySize = MAC_SRCMATCH_SHORT_ENTRY_SIZE;
+    if( osal_memcmp( pEntry, &macSrcMatchShadowTbl[index * entrySize], entrySize ) == TRUE )
+    {
+      /* Match found */
+      return index;
+    }
+    
+    index = macSrcMatchNext[index];
   }
-  else
+  
+  return MAC_SRCMATCH_INVALID_INDEX;
+}
+
+/*********************************************************************
+ * @fn          macSrcMatchHash
+ *
+ * @brief       Hash a source address table entry into a shadow index bucket
+ *
+ * @param       pEntry - entry in the radio RAM format
+ * @param       entrySize - MAC_SRCMATCH_SHORT_ENTRY_SIZE or MAC_SRCMATCH_EXT_ENTRY_SIZE
+ *
+ * @return      uint8 - bucket, 0 to MAC_SRCMATCH_HASH_SIZE-1
+ */
+static uint8 macSrcMatchHash( uint8 *pEntry, uint8 entrySize )
+{
+  uint8 hash = 0;
+  
+  while( entrySize-- )
   {
-    pAddr = addr->addr.extAddr;
-    entrySize = MAC_SRCMATCH_EXT_ENTRY_SIZE;
+    hash ^= *pEntry++;
   }
   
-  for( index = 0; index < macSrcMatchMaxNumEntries; index++ )
+  return ( ( hash ^ ( hash >> 4 ) ) & ( MAC_SRCMATCH_HASH_SIZE - 1 ) );
+}
+
+/*********************************************************************
+ * @fn          macSrcMatchShadowLoad
+ *
+ * @brief       Rebuild the shadow from the radio. Entries already enabled in
+ *              the radio are read back once and indexed, the rest of the 
+ *              first macSrcMatchMaxNumEntries entries go on the free list.
+ *
+ * @param       none
+ *
+ * @return      none
+ */
+static void macSrcMatchShadowLoad( void )
+{
+  uint8 index;
+  uint8 entrySize;
+  uint8 bucket;
+  
+  entrySize = MAC_SRCMATCH_ENTRY_SIZE();
+  macSrcMatchShadowEn = MAC_RADIO_SRC_MATCH_GET_EN();
+  macSrcMatchFreeHead = MAC_SRCMATCH_INVALID_INDEX;
+  osal_memset( macSrcMatchHashHead, MAC_SRCMATCH_INVALID_INDEX, MAC_SRCMATCH_HASH_SIZE );
+  
+  /* Walk down so that the free list hands out the lowest index first */
+  index = macSrcMatchMaxNumEntries;
+  while( index-- )
   {
-    /* Check if the entry is enabled */
-    if( macSrcMatchCheckEnableBit( index ) == FALSE )
+    if( macSrcMatchShadowEn & MAC_SRCMATCH_EN_BIT( index ) )
     {
-      continue; 
+      MAC_RADIO_SRC_MATCH_TABLE_READ( ( index * entrySize ), 
+                   &macSrcMatchShadowTbl[index * entrySize], entrySize );
+      bucket = macSrcMatchHash( &macSrcMatchShadowTbl[index * entrySize], entrySize );
+      macSrcMatchNext[index] = macSrcMatchHashHead[bucket];
+      macSrcMatchHashHead[bucket] = index;
     }
-      
-    /* Compare the short address and pan ID */
-    MAC_RADIO_SRC_MATCH_TABLE_READ( ( index * entrySize ), ramEntry, entrySize );
-     
-    if( osal_memcmp( pAddr, ramEntry, entrySize ) == TRUE )
+    else
     {
-      /* Match found */
-      return index;
+      macSrcMatchNext[index] = macSrcMatchFreeHead;
+      macSrcMatchFreeHead = index;
     }
   }
+}
+
+/*********************************************************************
+ * @fn          macSrcMatchShadowAdd
+ *
+ * @brief       Take an entry off the free list and index it in the shadow
+ *
+ * @param       index - index returned by macSrcMatchFindEmptyEntry()
+ * @param       pEntry - entry in the radio RAM format
+ * @param       entrySize - MAC_SRCMATCH_SHORT_ENTRY_SIZE or MAC_SRCMATCH_EXT_ENTRY_SIZE
+ *
+ * @return      none
+ */
+static void macSrcMatchShadowAdd( uint8 index, uint8 *pEntry, uint8 entrySize )
+{
+  uint8 bucket;
   
-  return MAC_SRCMATCH_INVALID_INDEX;
+  /* macSrcMatchFindEmptyEntry() always hands out the head of the free list */
+  macSrcMatchFreeHead = macSrcMatchNext[index];
+  
+  osal_memcpy( &macSrcMatchShadowTbl[index * entrySize], pEntry, entrySize );
+  bucket = macSrcMatchHash( pEntry, entrySize );
+  macSrcMatchNext[index] = macSrcMatchHashHead[bucket];
+  macSrcMatchHashHead[bucket] = index;
+}
+
+/*********************************************************************
+ * @fn          macSrcMatchShadowDelete
+ *
+ * @brief       Unlink an entry from its hash chain and return it to the 
+ *              free list
+ *
+ * @param       index - index of the entry in the source address table
+ * @param       entrySize - MAC_SRCMATCH_SHORT_ENTRY_SIZE or MAC_SRCMATCH_EXT_ENTRY_SIZE
+ *
+ * @return      none
+ */
+static void macSrcMatchShadowDelete( uint8 index, uint8 entrySize )
+{
+  uint8 *pLink;
+  
+  pLink = &macSrcMatchHashHead[macSrcMatchHash( &macSrcMatchShadowTbl[index * entrySize], entrySize )];
+  
+  while( *pLink != index )
+  {
+    pLink = &macSrcMatchNext[*pLink];
+  }
+  *pLink = macSrcMatchNext[index];
+  
+  macSrcMatchNext[index] = macSrcMatchFreeHead;
+  macSrcMatchFreeHead = index;
 }
 
 /*********************************************************************
@@ -473,7 +610,8 @@ static void macSrcMatchSetPendEnBit( uint8 index )
 /*********************************************************************
  * @fn          macSrcMatchSetEnableBit
  *
- * @brief       Set or clear the enable bit in the SRCMATCH EN register
+ * @brief       Set or clear the enable bit in the SRCMATCH EN register. The 
+ *              register is written from its shadow image, never read back.
  *
  * @param       index - index of the entry in the source address table
  * @param       option - true (set the enable bit), or false (clear the enable bit)
@@ -482,64 +620,23 @@ static void macSrcMatchSetPendEnBit( uint8 index )
  */
 static void macSrcMatchSetEnableBit( uint8 index, bool option )
 {
-  uint24 enable;  
-  
-  enable = MAC_RADIO_SRC_MATCH_GET_EN(); 
-      
   if( option == TRUE )
   {
-    if( macSrcMatchAddrMode == SADDR_MODE_SHORT )
-    {
-      enable |= ( (uint24)0x01 << index );
-      MAC_RADIO_SRC_MATCH_SET_SHORTEN( enable );
-    }
-    else
-    {
-      enable |= ( (uint24)0x01 << ( index * 2 ) );
-      MAC_RADIO_SRC_MATCH_SET_EXTEN( enable );
-    }
+    macSrcMatchShadowEn |= MAC_SRCMATCH_EN_BIT( index );
   }
   else
   {
-    if( macSrcMatchAddrMode == SADDR_MODE_SHORT )
-    {
-      enable &= ~( (uint24)0x01 << index );
-      MAC_RADIO_SRC_MATCH_SET_SHORTEN( enable );
-    }
-    else
-    {
-      enable &= ~( (uint24)0x01 << ( index * 2 ) );
-      MAC_RADIO_SRC_MATCH_SET_EXTEN( enable );
-    }
+    macSrcMatchShadowEn &= ~MAC_SRCMATCH_EN_BIT( index );
   }
-}
-
-/*********************************************************************
- * @fn          macSrcMatchCheckEnableBit
- *
- * @brief       Check the enable bit in the source address table
- *
- * @param       index - index of the entry in the source address table
- *
- * @return      TRUE or FALSE
- */
-static bool macSrcMatchCheckEnableBit( uint8 index )
-{
-  uint24 enable;
   
-  if( macSrcMatchAddrMode == SADDR_MODE_EXT )
+  if( macSrcMatchAddrMode == SADDR_MODE_SHORT )
   {
-    index *= 2;
+    MAC_RADIO_SRC_MATCH_SET_SHORTEN( macSrcMatchShadowEn );
   }
-  
-  enable = MAC_RADIO_SRC_MATCH_GET_EN();
-     
-  if( enable & ( (uint24)0x01 << index ) )
+  else
   {
-    return TRUE;
+    MAC_RADIO_SRC_MATCH_SET_EXTEN( macSrcMatchShadowEn );
   }
-
-  return FALSE; 
 }
  
 /*********************************************************************
@@ -46,6 +46,9 @@
 #include "hal_types.h"
 #include "hal_mcu.h"
 
+/* high-level */
+#include "mac_spec.h"
+
 /* exported low-level */
 #include "mac_low_level.h"
 
@@ -86,6 +89,19 @@ const uint16 CODE macBeaconMarginDCO[] =
 };
 #endif
 
+#ifdef PACKET_TRAFFIC_STATS
+/* traffic statistics, counted in the transmit and receive interrupt paths */
+macStats_t macStats;
+
+/* recency of each neighbour entry, 0 for the last one seen up to MAC_STATS_NBR_NUM-1 for the
+ * least recently seen one, which a new neighbour takes over
+ */
+static uint8 macStatsNbrRank[MAC_STATS_NBR_NUM];
+
+static void macStatsClear(void);
+static macStatsNbr_t * macStatsNbrFind(uint16 shortAddr);
+#endif
+
 /**************************************************************************************************
  * @fn          macLowLevelInit
  *
@@ -119,6 +135,10 @@ MAC_INTERNAL_API void macLowLevelInit(void)
   macRxInit();
   macTxInit();
   macBackoffTimerInit();
+
+#ifdef PACKET_TRAFFIC_STATS
+  macStatsClear();
+#endif
 }
 
 
@@ -151,5 +171,235 @@ MAC_INTERNAL_API void macLowLevelReset(void)
 }
 
 
+/**************************************************************************************************
+ * @fn          macLowLevelStatsTx
+ *
+ * @brief       Count a completed transmit attempt in the traffic statistics.  Unicasts to a
+ *              short address are also counted against the neighbour.
+ *
+ * @param       pMhr       - pointer to the MAC header of the frame
+ * @param       status     - status the attempt completed with
+ * @param       retransmit - non-zero if the attempt was a retransmission
+ *
+ * @return      none
+ **************************************************************************************************
+ */
+MAC_INTERNAL_API void macLowLevelStatsTx(uint8 * pMhr, uint8 status, uint8 retransmit)
+{
+#ifdef PACKET_TRAFFIC_STATS
+  halIntState_t  s;
+  macStatsNbr_t * pNbr;
+  uint16 dstAddr;
+
+  HAL_ENTER_CRITICAL_SECTION(s);
+
+  macStats.txAttempts++;
+  if (retransmit)
+  {
+    macStats.txRetries++;
+  }
+  if (status == MAC_CHANNEL_ACCESS_FAILURE)
+  {
+    macStats.channelAccessFailures++;
+  }
+  else if (status == MAC_NO_ACK)
+  {
+    macStats.noAck++;
+  }
+
+  /* destination address follows the sequence number and destination PAN ID */
+  if ((pMhr != NULL) && (MAC_DEST_ADDR_MODE(pMhr) == SADDR_MODE_SHORT))
+  {
+    dstAddr = BUILD_UINT16(pMhr[MAC_SEQ_NUM_OFFSET + 1 + MAC_PAN_ID_FIELD_LEN],
+                           pMhr[MAC_SEQ_NUM_OFFSET + 2 + MAC_PAN_ID_FIELD_LEN]);
+    if (dstAddr != MAC_SHORT_ADDR_BROADCAST)
+    {
+      pNbr = macStatsNbrFind(dstAddr);
+      pNbr->txFrames++;
+      if (status == MAC_NO_ACK)
+      {
+        pNbr->noAck++;
+      }
+    }
+  }
+
+  HAL_EXIT_CRITICAL_SECTION(s);
+#else
+  (void)pMhr;
+  (void)status;
+  (void)retransmit;
+#endif
+}
+
+
+/**************************************************************************************************
+ * @fn          macLowLevelStatsRx
+ *
+ * @brief       Count a frame received with a good CRC in the traffic statistics.  A frame
+ *              requesting an ACK that repeats the sequence number of the last frame from the
+ *              same neighbour is a retransmission after a lost ACK, and is counted as duplicate.
+ *
+ * @param       pMsg - pointer to the receive structure, source address and DSN filled in
+ *
+ * @return      none
+ **************************************************************************************************
+ */
+MAC_INTERNAL_API void macLowLevelStatsRx(macRx_t * pMsg)
+{
+#ifdef PACKET_TRAFFIC_STATS
+  halIntState_t  s;
+  macStatsNbr_t * pNbr;
+
+  HAL_ENTER_CRITICAL_SECTION(s);
+
+  macStats.rxFrames++;
+
+  if (pMsg->mac.srcAddr.addrMode == SADDR_MODE_SHORT)
+  {
+    pNbr = macStatsNbrFind(pMsg->mac.srcAddr.addr.shortAddr);
+
+    if ((pMsg->internal.flags & MAC_RX_FLAG_ACK_REQUEST) &&
+        (pNbr->rxFrames != 0) && (pNbr->lastSeq == pMsg->mac.dsn))
+    {
+      pNbr->duplicates++;
+      macStats.rxDuplicates++;
+    }
+
+    pNbr->rxFrames++;
+    pNbr->lastSeq = pMsg->mac.dsn;
+  }
+
+  HAL_EXIT_CRITICAL_SECTION(s);
+#else
+  (void)pMsg;
+#endif
+}
+
+
+/**************************************************************************************************
+ * @fn          macLowLevelStatsRead
+ *
+ * @brief       Copy out the traffic statistics, optionally restarting them.
+ *
+ * @param       pStats - pointer to the structure to fill in
+ * @param       clear  - non-zero to clear the statistics and forget the neighbours after reading
+ *
+ * @return      TRUE if the statistics are built in (PACKET_TRAFFIC_STATS), FALSE otherwise
+ **************************************************************************************************
+ */
+MAC_INTERNAL_API uint8 macLowLevelStatsRead(macStats_t * pStats, uint8 clear)
+{
+#ifdef PACKET_TRAFFIC_STATS
+  halIntState_t  s;
+
+  HAL_ENTER_CRITICAL_SECTION(s);
+  *pStats = macStats;
+  if (clear)
+  {
+    macStatsClear();
+  }
+  HAL_EXIT_CRITICAL_SECTION(s);
+
+  return(TRUE);
+#else
+  (void)pStats;
+  (void)clear;
+
+  return(FALSE);
+#endif
+}
+
+
+#ifdef PACKET_TRAFFIC_STATS
+/*=================================================================================================
+ * @fn          macStatsClear
+ *
+ * @brief       Zero the traffic statistics and mark every neighbour entry unused.
+ *
+ * @param       none
+ *
+ * @return      none
+ *=================================================================================================
+ */
+static void macStatsClear(void)
+{
+  uint8 * p = (uint8 *)&macStats;
+  uint16 i;
+
+  for (i = 0; i < sizeof(macStats); i++)
+  {
+    p[i] = 0;
+  }
+
+  for (i = 0; i < MAC_STATS_NBR_NUM; i++)
+  {
+    macStats.nbr[i].shortAddr = MAC_SHORT_ADDR_BROADCAST;
+    macStatsNbrRank[i] = (uint8)i;
+  }
+}
+
+
+/*=================================================================================================
+ * @fn          macStatsNbrFind
+ *
+ * @brief       Find the neighbour entry of a short address and mark it the most recently seen.
+ *              A neighbour not tracked yet takes over the least recently seen entry, unused
+ *              entries first, so busy neighbours keep their counts while others come and go.
+ *
+ * @param       shortAddr - neighbour short address
+ *
+ * @return      pointer to the neighbour entry
+ *=================================================================================================
+ */
+static macStatsNbr_t * macStatsNbrFind(uint16 shortAddr)
+{
+  macStatsNbr_t * pNbr;
+  uint8 i;
+  uint8 found = MAC_STATS_NBR_NUM;
+  uint8 oldest = 0;
+  uint8 rank;
+
+  for (i = 0; i < MAC_STATS_NBR_NUM; i++)
+  {
+    if (macStats.nbr[i].shortAddr == shortAddr)
+    {
+      found = i;
+      break;
+    }
+    if (macStatsNbrRank[i] == (MAC_STATS_NBR_NUM - 1))
+    {
+      oldest = i;
+    }
+  }
+
+  if (found == MAC_STATS_NBR_NUM)
+  {
+    found = oldest;
+
+    pNbr = &macStats.nbr[found];
+    pNbr->shortAddr  = shortAddr;
+    pNbr->txFrames   = 0;
+    pNbr->noAck      = 0;
+    pNbr->rxFrames   = 0;
+    pNbr->duplicates = 0;
+    pNbr->lastSeq    = 0;
+  }
+
+  /* every entry seen more recently than this one ages by one */
+  rank = macStatsNbrRank[found];
+  for (i = 0; i < MAC_STATS_NBR_NUM; i++)
+  {
+    if (macStatsNbrRank[i] < rank)
+    {
+      macStatsNbrRank[i]++;
+    }
+  }
+  macStatsNbrRank[found] = 0;
+
+  return(&macStats.nbr[found]);
+}
+#endif
+
+
 /**************************************************************************************************
 */
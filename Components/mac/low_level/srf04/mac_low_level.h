@@ -71,6 +71,47 @@
 #define MAC_PROMISCUOUS_MODE_COMPLIANT      0x01
 #define MAC_PROMISCUOUS_MODE_WITH_BAD_CRC   0x02
 
+/* neighbours tracked by the traffic statistics (PACKET_TRAFFIC_STATS) */
+#ifndef MAC_STATS_NBR_NUM
+#define MAC_STATS_NBR_NUM                   8
+#endif
+
+/* counting of the traffic statistics that need no per frame decoding */
+#ifdef PACKET_TRAFFIC_STATS
+#define MAC_STATS_INC(field)                st( macStats.field++; )
+#else
+#define MAC_STATS_INC(field)
+#endif
+
+
+/* ------------------------------------------------------------------------------------------------
+ *                                           Typedefs
+ * ------------------------------------------------------------------------------------------------
+ */
+typedef struct
+{
+  uint16  shortAddr;              /* neighbour short address, 0xFFFF if the entry is unused */
+  uint16  txFrames;               /* unicast transmit attempts to the neighbour */
+  uint16  noAck;                  /* of those, attempts that were not acknowledged */
+  uint16  rxFrames;               /* frames with a good CRC received from the neighbour */
+  uint16  duplicates;             /* received frames repeating the last sequence number */
+  uint8   lastSeq;                /* sequence number of the last frame received */
+} macStatsNbr_t;
+
+typedef struct
+{
+  uint32  txAttempts;             /* frames handed to the radio, retransmissions included */
+  uint32  txRetries;              /* of those, retransmissions */
+  uint32  ccaBusy;                /* clear channel assessments that found the channel busy */
+  uint32  channelAccessFailures;  /* attempts abandoned after the last CSMA backoff */
+  uint32  noAck;                  /* attempts that were not acknowledged */
+  uint32  rxFrames;               /* frames received with a good CRC */
+  uint32  rxCrcFailures;          /* frames received with a bad CRC */
+  uint32  rxFifoOverflows;        /* receive FIFO overflows */
+  uint32  rxDuplicates;           /* acknowledged frames received twice (our ACK was lost) */
+  macStatsNbr_t nbr[MAC_STATS_NBR_NUM];
+} macStats_t;
+
 
 /* ------------------------------------------------------------------------------------------------
  *                                           Global Externs
@@ -81,6 +122,10 @@ extern uint8 const macTxSlottedDelay;
 /* beacon interval margin */
 extern uint16 macBeaconMargin[];
 
+#ifdef PACKET_TRAFFIC_STATS
+extern macStats_t macStats;
+#endif
+
 
 /* ------------------------------------------------------------------------------------------------
  *                                           Prototypes
@@ -90,6 +135,9 @@ extern uint16 macBeaconMargin[];
 /* mac_low_level.c */
 MAC_INTERNAL_API void macLowLevelInit(void);
 MAC_INTERNAL_API void macLowLevelReset(void);
+MAC_INTERNAL_API void macLowLevelStatsTx(uint8 * pMhr, uint8 status, uint8 retransmit);
+MAC_INTERNAL_API void macLowLevelStatsRx(macRx_t * pMsg);
+MAC_INTERNAL_API uint8 macLowLevelStatsRead(macStats_t * pStats, uint8 clear);
 
 /* mac_sleep.c */
 MAC_INTERNAL_API void macSleepWakeUp(void);
@@ -72,6 +72,11 @@
 /* debug */
 #include "mac_assert.h"
 
+/* capture */
+#if (defined HAL_SNIFFER) && (HAL_SNIFFER == TRUE)
+#include "hal_sniffer.h"
+#endif
+
 
 /* ------------------------------------------------------------------------------------------------
  *                                            Defines
@@ -153,6 +158,7 @@
 uint8 macRxActive;
 uint8 macRxFilter;
 uint8 macRxOutgoingAckFlag;
+uint8 macRxFrameCnt;        /* free running, for callers that only look for receive activity */
 
 
 /* ------------------------------------------------------------------------------------------------
@@ -190,6 +196,10 @@ static void rxDiscardFrame(void);
 static void rxDone(void);
 static void rxPostRxUpdates(void);
 
+#ifdef MAC_ISR_STATS
+  static void rxIsrStatsRecord(void (* pFuncState)(void), uint32 stamp);
+#endif
+
 
 /* ------------------------------------------------------------------------------------------------
  *                                         Local Variables
@@ -208,6 +218,12 @@ static uint8  rxIsrActiveFlag;
 static uint8  rxResetFlag;
 static uint8  rxFifoOverflowCount;
 
+#if (defined HAL_SNIFFER) && (HAL_SNIFFER == TRUE)
+  /* header of an unsecured frame, which is parsed rather than kept in the receive buffer */
+  static uint8  rxSnifferHdr[MAC_FCF_FIELD_LEN + MAC_SEQ_NUM_FIELD_LEN + MAX_ADDR_FIELDS_LEN];
+  static uint8  rxSnifferHdrLen;
+#endif
+
 #ifdef PACKET_FILTER_STATS
   uint32      rxCrcFailure = 0;
   uint32      rxCrcSuccess = 0;
@@ -370,6 +386,11 @@ static void rxHaltCleanupFinalStep(void)
  */
 MAC_INTERNAL_API void macRxThresholdIsr(void)
 {
+#ifdef MAC_ISR_STATS
+  void (* pFuncState)(void) = pFuncRxState;
+  uint32 stamp;
+#endif
+
   /* if currently reseting, do not execute receive ISR logic */
   if (rxResetFlag)
   {
@@ -384,7 +405,11 @@ MAC_INTERNAL_API void macRxThresholdIsr(void)
    *  executing the ISR.
    */
   rxIsrActiveFlag = 1;
+  MAC_MCU_ISR_STATS_START(stamp);
   (*pFuncRxState)();
+#ifdef MAC_ISR_STATS
+  rxIsrStatsRecord(pFuncState, stamp);
+#endif
   rxIsrActiveFlag = 0;
 
   /* if a reset occurred during the ISR, peform cleanup here */
@@ -590,6 +615,9 @@ static void rxStartIsr(void)
     else
     {
       HAL_EXIT_CRITICAL_SECTION(s);
+
+      /* the ACK arrived after transmit gave up on it (or was never asked for) */
+      MAC_MCU_ISR_STATS_EVENT(lateAck);
     }
 
     /* receive is done, exit from here */
@@ -774,6 +802,18 @@ static void rxStartIsr(void)
   pRxBuf->mhr.p   = pRxBuf->msdu.p   = (uint8 *) (pRxBuf + 1);
   pRxBuf->mhr.len = pRxBuf->msdu.len =  rxPayloadLen;
 
+#if (defined HAL_SNIFFER) && (HAL_SNIFFER == TRUE)
+  /* a secured frame needs no copy, its whole header is kept in the buffer for the security layer */
+  rxSnifferHdrLen = 0;
+  if (rxPromiscuousMode && !MAC_SEC_ENABLED(&rxBuf[1]))
+  {
+    rxSnifferHdr[0] = rxBuf[1];
+    rxSnifferHdr[1] = rxBuf[2];
+    rxSnifferHdr[2] = rxBuf[3];
+    rxSnifferHdrLen = MAC_FCF_FIELD_LEN + MAC_SEQ_NUM_FIELD_LEN;
+  }
+#endif
+
   if (MAC_SEC_ENABLED(&rxBuf[1]))
   {
     /* Copy FCF and sequence number to RX buffer */
@@ -846,6 +886,14 @@ static void rxAddrIsr(void)
   /*  read out address fields into local buffer in one shot */
   MAC_RADIO_READ_RX_FIFO(buf, rxNextLen);
 
+#if (defined HAL_SNIFFER) && (HAL_SNIFFER == TRUE)
+  if (rxSnifferHdrLen)
+  {
+    osal_memcpy(&rxSnifferHdr[rxSnifferHdrLen], buf, rxNextLen);
+    rxSnifferHdrLen += rxNextLen;
+  }
+#endif
+
   /* set pointer to buffer with addressing fields */
   p = buf;
 
@@ -1084,6 +1132,29 @@ static void rxFcsIsr(void)
 
   /* save the "CRC-is-OK" status */
   crcOK = PROPRIETARY_FCS_CRC_OK(rxBuf);
+  macRxFrameCnt++;
+
+#if (defined HAL_SNIFFER) && (HAL_SNIFFER == TRUE)
+  /* capture every frame heard in promiscuous mode, bad CRCs included */
+  if (rxPromiscuousMode)
+  {
+    halSnifferHdr_t snifferHdr;
+    int8 rssiDbm;
+
+    rssiDbm = PROPRIETARY_FCS_RSSI(rxBuf) + MAC_RADIO_RSSI_OFFSET;
+    MAC_RADIO_RSSI_LNA_OFFSET(rssiDbm);
+
+    snifferHdr.backoff = pRxBuf->mac.timestamp;
+    snifferHdr.timer   = pRxBuf->mac.timestamp2;
+    snifferHdr.channel = macPhyChannel;
+    snifferHdr.rssi    = rssiDbm;
+    snifferHdr.lqi     = macRadioComputeLQI(rssiDbm, PROPRIETARY_FCS_CORRELATION_VALUE(rxBuf));
+    snifferHdr.crcOk   = crcOK;
+
+    HalSnifferFrame(&snifferHdr, rxSnifferHdr, rxSnifferHdrLen,
+                    (uint8 *)(pRxBuf + 1), (uint8)pRxBuf->mhr.len);
+  }
+#endif
 
   /*
    *  See if the frame should be passed up to high-level MAC.  If the CRC is OK, the
@@ -1099,6 +1170,13 @@ static void rxFcsIsr(void)
     rxCrcSuccess++;
 #endif /* PACKET_FILTER_STATS */
 
+#ifdef PACKET_TRAFFIC_STATS
+    if (crcOK)
+    {
+      macLowLevelStatsRx(pRxBuf);
+    }
+#endif /* PACKET_TRAFFIC_STATS */
+
     /*
      *  As power saving optimization, set state variable to indicate physical receive
      *  has completed and then request turning of the receiver.  This means the receiver
@@ -1141,6 +1219,7 @@ static void rxFcsIsr(void)
 #ifdef PACKET_FILTER_STATS
     rxCrcFailure++;
 #endif /* PACKET_FILTER_STATS */
+    MAC_STATS_INC(rxCrcFailures);
 
     /*
      *  The CRC is bad so no ACK was sent.  Cancel any callback and clear the flag.
@@ -1328,10 +1407,55 @@ static void rxDiscardIsr(void)
 MAC_INTERNAL_API void macRxFifoOverflowIsr(void)
 {
   rxFifoOverflowCount++; /* This flag is used for debug purpose only */
+  MAC_MCU_ISR_STATS_EVENT(rxFifoOverflow);
+  MAC_STATS_INC(rxFifoOverflows);
   macRxHaltCleanup();
 }
 
 
+#ifdef MAC_ISR_STATS
+/*=================================================================================================
+ * @fn          rxIsrStatsRecord
+ *
+ * @brief       Records the cycles spent in one receive state handler.
+ *
+ * @param       pFuncState - receive state handler that was executed
+ * @param       stamp      - stamp taken before the handler was called
+ *
+ * @return      none
+ *=================================================================================================
+ */
+static void rxIsrStatsRecord(void (* pFuncState)(void), uint32 stamp)
+{
+  uint8 id;
+
+  if (pFuncState == &rxStartIsr)
+  {
+    id = MAC_MCU_ISR_RX_START;
+  }
+  else if (pFuncState == &rxAddrIsr)
+  {
+    id = MAC_MCU_ISR_RX_ADDR;
+  }
+  else if (pFuncState == &rxPayloadIsr)
+  {
+    id = MAC_MCU_ISR_RX_PAYLOAD;
+  }
+  else if (pFuncState == &rxFcsIsr)
+  {
+    id = MAC_MCU_ISR_RX_FCS;
+  }
+  else
+  {
+    /* security header and discard states are not tracked */
+    return;
+  }
+
+  macMcuIsrStatsRecord(id, stamp);
+}
+#endif /* MAC_ISR_STATS */
+
+
 /**************************************************************************************************
  * @fn          macRxPromiscuousMode
  *
@@ -79,6 +79,7 @@
 extern uint8 macRxActive;
 extern uint8 macRxFilter;
 extern uint8 macRxOutgoingAckFlag;
+extern uint8 macRxFrameCnt;
 
 #ifdef PACKET_FILTER_STATS
   extern uint32 rxCrcFailure;
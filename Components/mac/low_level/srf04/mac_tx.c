@@ -77,6 +77,27 @@
 #define MFR_LEN                   MAC_FCS_FIELD_LEN
 #define PREPENDED_BYTE_LEN        1
 
+/*
+ *  Adaptive CSMA (MAC_ADAPTIVE_CSMA).  Busy CCAs and missing ACKs are filtered into rates.
+ *  Every window of transmits, the backoff parameters are stepped up by one while either rate
+ *  is high and stepped back down while both are low.  Each step adds one to the PIB values of
+ *  macMinBE, macMaxBE and macMaxCSMABackoffs, clipped to the limits the standard allows.
+ */
+#define TX_ADAPT_WINDOW           8
+#define TX_ADAPT_MAX_STEP         3
+#define TX_ADAPT_RATE_HIGH        96      /* ~38% */
+#define TX_ADAPT_RATE_LOW         32      /* ~12% */
+#define TX_ADAPT_MAX_BE_LIMIT     8
+#define TX_ADAPT_BACKOFFS_LIMIT   5
+
+#ifdef MAC_ADAPTIVE_CSMA
+#define TX_MAX_BE                 txCsma.maxBe
+#define TX_MAX_CSMA_BACKOFFS      txCsma.maxCsmaBackoffs
+#else
+#define TX_MAX_BE                 macPib.maxBe
+#define TX_MAX_CSMA_BACKOFFS      macPib.maxCsmaBackoffs
+#endif
+
 
 /* ------------------------------------------------------------------------------------------------
  *                                         Global Constants
@@ -116,6 +137,11 @@ static uint8 txSeqn;
 static uint8 txAckReq;
 static uint8 txRetransmitFlag;
 
+#ifdef MAC_ADAPTIVE_CSMA
+static macTxCsmaState_t txCsma;
+static uint8 txCsmaWindow;
+#endif
+
 
 /* ------------------------------------------------------------------------------------------------
  *                                         Local Prototypes
@@ -126,6 +152,12 @@ static void txGo(void);
 static void txCsmaGo(void);
 static void txComplete(uint8 status);
 
+#ifdef MAC_ADAPTIVE_CSMA
+static void txCsmaAdaptPrep(void);
+static uint8 txCsmaAdaptRate(uint8 rate, uint8 hit);
+static void txCsmaAdaptUpdate(uint8 status);
+#endif
+
 
 /**************************************************************************************************
  * @fn          macTxInit
@@ -209,7 +241,12 @@ MAC_INTERNAL_API void macTxFrame(uint8 txType)
     MAC_ASSERT((macTxType == MAC_TX_TYPE_SLOTTED_CSMA) || (macTxType == MAC_TX_TYPE_UNSLOTTED_CSMA));
 
     nb = 0;
+#ifdef MAC_ADAPTIVE_CSMA
+    txCsmaAdaptPrep();
+    macTxBe = (pMacDataTx->internal.txOptions & MAC_TXOPTION_ALT_BE) ? macPib.altBe : txCsma.minBe;
+#else
     macTxBe = (pMacDataTx->internal.txOptions & MAC_TXOPTION_ALT_BE) ? macPib.altBe : macPib.minBe;
+#endif
 
     if ((macTxType == MAC_TX_TYPE_SLOTTED_CSMA) && (macPib.battLifeExt))
     {
@@ -443,15 +480,20 @@ MAC_INTERNAL_API void macTxChannelBusyCallback(void)
   macTxActive = MAC_TX_ACTIVE_CHANNEL_BUSY;
   macRxOffRequest();
 
+#ifdef MAC_ADAPTIVE_CSMA
+  txCsma.ccaBusyRate = txCsmaAdaptRate(txCsma.ccaBusyRate, TRUE);
+#endif
+  MAC_STATS_INC(ccaBusy);
+
   /*  clear channel assement failed, follow through with CSMA algorithm */
   nb++;
-  if (nb > macPib.maxCsmaBackoffs)
+  if (nb > TX_MAX_CSMA_BACKOFFS)
   {
     txComplete(MAC_CHANNEL_ACCESS_FAILURE);
   }
   else
   {
-    macTxBe = MIN(macTxBe+1, macPib.maxBe);
+    macTxBe = MIN(macTxBe+1, TX_MAX_BE);
     txCsmaPrep();
     macTxActive = MAC_TX_ACTIVE_GO;
     txCsmaGo();
@@ -481,6 +523,14 @@ MAC_INTERNAL_API void macTxDoneCallback(void)
   HAL_ENTER_CRITICAL_SECTION(s);
   if (macTxActive == MAC_TX_ACTIVE_GO)
   {
+#ifdef MAC_ADAPTIVE_CSMA
+    /* the frame went out, so the last clear channel assessment passed */
+    if (macTxType != MAC_TX_TYPE_SLOTTED)
+    {
+      txCsma.ccaBusyRate = txCsmaAdaptRate(txCsma.ccaBusyRate, FALSE);
+    }
+#endif
+
     /* see if ACK was requested */
     if (!txAckReq)
     {
@@ -613,6 +663,13 @@ MAC_INTERNAL_API void macTxAckNotReceivedCallback(void)
  */
 static void txComplete(uint8 status)
 {
+#ifdef MAC_ADAPTIVE_CSMA
+  txCsmaAdaptUpdate(status);
+#endif
+#ifdef PACKET_TRAFFIC_STATS
+  macLowLevelStatsTx((pMacDataTx != NULL) ? pMacDataTx->msdu.p : NULL, status, txRetransmitFlag);
+#endif
+
   /* reset the retransmit flag */
   txRetransmitFlag = 0;
 
@@ -673,6 +730,129 @@ MAC_INTERNAL_API void macTxCollisionWithRxCallback(void)
 }
 
 
+#ifdef MAC_ADAPTIVE_CSMA
+/*=================================================================================================
+ * @fn          txCsmaAdaptPrep
+ *
+ * @brief       Derives the CSMA parameters for the next transmit from the PIB and the current
+ *              escalation step.
+ *
+ * @param       none
+ *
+ * @return      none
+ *=================================================================================================
+ */
+static void txCsmaAdaptPrep(void)
+{
+  txCsma.maxBe = MAX(macPib.maxBe, MIN(macPib.maxBe + txCsma.step, TX_ADAPT_MAX_BE_LIMIT));
+  txCsma.minBe = MIN(macPib.minBe + txCsma.step, txCsma.maxBe);
+  txCsma.maxCsmaBackoffs = MAX(macPib.maxCsmaBackoffs,
+                               MIN(macPib.maxCsmaBackoffs + txCsma.step, TX_ADAPT_BACKOFFS_LIMIT));
+}
+
+
+/*=================================================================================================
+ * @fn          txCsmaAdaptRate
+ *
+ * @brief       Folds one outcome into a filtered rate (1/8 weight per outcome).
+ *
+ * @param       rate - current rate in units of 1/256
+ * @param       hit  - TRUE if the outcome counts toward the rate
+ *
+ * @return      updated rate
+ *=================================================================================================
+ */
+static uint8 txCsmaAdaptRate(uint8 rate, uint8 hit)
+{
+  rate -= rate >> 3;
+
+  /* 31 rather than 32 keeps the rate within a byte */
+  return (hit ? (rate + 31) : rate);
+}
+
+
+/*=================================================================================================
+ * @fn          txCsmaAdaptUpdate
+ *
+ * @brief       Accounts for a completed transmit and, once per window, steps the CSMA
+ *              parameters toward the measured contention.
+ *
+ * @param       status - status of the transmit that just went out
+ *
+ * @return      none
+ *=================================================================================================
+ */
+static void txCsmaAdaptUpdate(uint8 status)
+{
+  if (macTxType == MAC_TX_TYPE_SLOTTED)
+  {
+    return;
+  }
+
+  if (txAckReq && ((status == MAC_SUCCESS) || (status == MAC_ACK_PENDING) || (status == MAC_NO_ACK)))
+  {
+    txCsma.noAckRate = txCsmaAdaptRate(txCsma.noAckRate, (status == MAC_NO_ACK));
+  }
+
+  if (++txCsmaWindow < TX_ADAPT_WINDOW)
+  {
+    return;
+  }
+  txCsmaWindow = 0;
+
+  if ((txCsma.ccaBusyRate > TX_ADAPT_RATE_HIGH) || (txCsma.noAckRate > TX_ADAPT_RATE_HIGH))
+  {
+    if (txCsma.step < TX_ADAPT_MAX_STEP)
+    {
+      txCsma.step++;
+    }
+  }
+  else if ((txCsma.ccaBusyRate < TX_ADAPT_RATE_LOW) && (txCsma.noAckRate < TX_ADAPT_RATE_LOW))
+  {
+    if (txCsma.step > 0)
+    {
+      txCsma.step--;
+    }
+  }
+}
+#endif /* MAC_ADAPTIVE_CSMA */
+
+
+/**************************************************************************************************
+ * @fn          macTxCsmaStateRead
+ *
+ * @brief       Copies out the adaptive CSMA state.
+ *
+ * @param       pState - buffer for the state
+ *
+ * @return      TRUE if adaptive CSMA is built in (MAC_ADAPTIVE_CSMA); otherwise the state
+ *              reports the PIB parameters with no escalation
+ **************************************************************************************************
+ */
+MAC_INTERNAL_API uint8 macTxCsmaStateRead(macTxCsmaState_t *pState)
+{
+#ifdef MAC_ADAPTIVE_CSMA
+  halIntState_t  s;
+
+  HAL_ENTER_CRITICAL_SECTION(s);
+  txCsmaAdaptPrep();
+  *pState = txCsma;
+  HAL_EXIT_CRITICAL_SECTION(s);
+
+  return (TRUE);
+#else
+  pState->ccaBusyRate = 0;
+  pState->noAckRate = 0;
+  pState->step = 0;
+  pState->minBe = macPib.minBe;
+  pState->maxBe = macPib.maxBe;
+  pState->maxCsmaBackoffs = macPib.maxCsmaBackoffs;
+
+  return (FALSE);
+#endif
+}
+
+
 
 /**************************************************************************************************
  *                                  Compile Time Integrity Checks
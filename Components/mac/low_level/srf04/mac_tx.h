@@ -73,6 +73,22 @@
 #define MAC_TX_IS_PHYSICALLY_ACTIVE()       (macTxActive & MAC_TX_ACTIVE_PHYSICALLY_BV)
 
 
+/* ------------------------------------------------------------------------------------------------
+ *                                         Typedefs
+ * ------------------------------------------------------------------------------------------------
+ */
+/* adaptive CSMA state, rates are filtered fractions in units of 1/256 */
+typedef struct
+{
+  uint8 ccaBusyRate;          /* clear channel assessments that found the channel busy */
+  uint8 noAckRate;            /* acknowledged transmits that got no ACK */
+  uint8 step;                 /* escalation added to the PIB CSMA parameters */
+  uint8 minBe;                /* CSMA parameters in effect */
+  uint8 maxBe;
+  uint8 maxCsmaBackoffs;
+} macTxCsmaState_t;
+
+
 /* ------------------------------------------------------------------------------------------------
  *                                   Global Variable Externs
  * ------------------------------------------------------------------------------------------------
@@ -96,6 +112,7 @@ MAC_INTERNAL_API void macTxAckReceivedCallback(uint8 seqn, uint8 pendingFlag);
 MAC_INTERNAL_API void macTxAckNotReceivedCallback(void);
 MAC_INTERNAL_API void macTxTimestampCallback(void);
 MAC_INTERNAL_API void macTxCollisionWithRxCallback(void);
+MAC_INTERNAL_API uint8 macTxCsmaStateRead(macTxCsmaState_t *pState);
 
 
 /**************************************************************************************************
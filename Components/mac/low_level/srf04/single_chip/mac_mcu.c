@@ -46,6 +46,9 @@
 #include "hal_defs.h"
 #include "hal_mcu.h"
 
+/* OSAL */
+#include "OSAL.h"
+
 /* low-level specific */
 #include "mac_rx.h"
 #include "mac_tx.h"
@@ -97,6 +100,10 @@ static uint32 accumulatedOverflowCount = 0;
 
 /* Function pointer for the random seed callback */
 static macRNGFcn_t pRandomSeedCB = NULL;
+
+#ifdef MAC_ISR_STATS
+macMcuIsrStats_t macMcuIsrStats;
+#endif
 /* ------------------------------------------------------------------------------------------------
  *                                       Local Prototypes
  * ------------------------------------------------------------------------------------------------
@@ -670,6 +677,9 @@ HAL_ISR_FUNCTION( macMcuTimer2Isr, T2_VECTOR )
 {
   uint8 t2irqm;
   uint8 t2irqf;
+#ifdef MAC_ISR_STATS
+  uint32 stamp;
+#endif
   
   HAL_ENTER_ISR();
 
@@ -684,7 +694,9 @@ HAL_ISR_FUNCTION( macMcuTimer2Isr, T2_VECTOR )
   {
 
     /* call function for dealing with the timer compare interrupt */
+    MAC_MCU_ISR_STATS_START(stamp);
     macBackoffTimerCompareIsr();
+    MAC_MCU_ISR_STATS_STOP(MAC_MCU_ISR_BACKOFF_COMPARE, stamp);
 
     /* clear overflow compare interrupt flag */
     T2IRQF = ~TIMER2_OVF_COMPARE1F;
@@ -792,6 +804,129 @@ uint32 macMcuPrecisionCount(void)
 }
 
 
+#ifdef MAC_ISR_STATS
+/**************************************************************************************************
+ * @fn          macMcuIsrStatsStamp
+ *
+ * @brief       Reads the MAC timer and the low byte of its overflow counter as one stamp for
+ *              timing an interrupt handler.
+ *
+ * @param       none
+ *
+ * @return      overflow count low byte in bits 16-23, timer count in bits 0-15
+ **************************************************************************************************
+ */
+MAC_INTERNAL_API uint32 macMcuIsrStatsStamp(void)
+{
+  uint32         stamp;
+  uint8          t2msel;
+  halIntState_t  s;
+
+  HAL_ENTER_CRITICAL_SECTION(s);
+
+  /* the handler being timed may have left T2MSEL pointing elsewhere */
+  t2msel = T2MSEL;
+  MAC_MCU_T2_ACCESS_OVF_COUNT_VALUE();
+
+  /* reading T2M0 latches T2M1 and T2MOVFx */
+  ((uint8 *)&stamp)[UINT32_NDX0] = T2M0;
+  ((uint8 *)&stamp)[UINT32_NDX1] = T2M1;
+  ((uint8 *)&stamp)[UINT32_NDX2] = T2MOVF0;
+  ((uint8 *)&stamp)[UINT32_NDX3] = 0;
+
+  T2MSEL = t2msel;
+  HAL_EXIT_CRITICAL_SECTION(s);
+
+  return (stamp);
+}
+
+
+/**************************************************************************************************
+ * @fn          macMcuIsrStatsRecord
+ *
+ * @brief       Adds the cycles elapsed since a stamp to the statistics of a handler.
+ *
+ * @param       id    - MAC_MCU_ISR_xxx slot of the handler
+ * @param       start - stamp taken when the handler was entered
+ *
+ * @return      none
+ **************************************************************************************************
+ */
+MAC_INTERNAL_API void macMcuIsrStatsRecord(uint8 id, uint32 start)
+{
+  uint32 now = macMcuIsrStatsStamp();
+  macMcuIsrCycles_t *pCycles = &macMcuIsrStats.cycles[id];
+  uint32 cycles;
+  halIntState_t s;
+
+  /* the timer wraps once per backoff, so the overflow counter supplies the whole periods */
+  cycles = (uint32)(uint8)(((uint8 *)&now)[UINT32_NDX2] - ((uint8 *)&start)[UINT32_NDX2]) *
+           MAC_RADIO_TIMER_TICKS_PER_BACKOFF();
+  cycles += (uint16)now;
+  cycles -= (uint16)start;
+
+  if (cycles > 0xFFFF)
+  {
+    cycles = 0xFFFF;
+  }
+
+  HAL_ENTER_CRITICAL_SECTION(s);
+  if ((pCycles->count == 0) || ((uint16)cycles < pCycles->min))
+  {
+    pCycles->min = (uint16)cycles;
+  }
+  if ((uint16)cycles > pCycles->max)
+  {
+    pCycles->max = (uint16)cycles;
+  }
+
+  /* halve the running sum rather than let the average stop moving */
+  if (pCycles->count == 0xFFFF)
+  {
+    pCycles->count >>= 1;
+    pCycles->total >>= 1;
+  }
+  pCycles->count++;
+  pCycles->total += cycles;
+  HAL_EXIT_CRITICAL_SECTION(s);
+}
+#endif /* MAC_ISR_STATS */
+
+
+/**************************************************************************************************
+ * @fn          macMcuIsrStatsRead
+ *
+ * @brief       Copies out the interrupt handler statistics, optionally clearing them.
+ *
+ * @param       pStats - buffer for the statistics
+ * @param       clear  - TRUE to restart the statistics once they are read
+ *
+ * @return      TRUE if the statistics are collected in this build (MAC_ISR_STATS)
+ **************************************************************************************************
+ */
+MAC_INTERNAL_API uint8 macMcuIsrStatsRead(macMcuIsrStats_t *pStats, uint8 clear)
+{
+#ifdef MAC_ISR_STATS
+  halIntState_t s;
+
+  HAL_ENTER_CRITICAL_SECTION(s);
+  *pStats = macMcuIsrStats;
+  if (clear)
+  {
+    osal_memset(&macMcuIsrStats, 0, sizeof(macMcuIsrStats));
+  }
+  HAL_EXIT_CRITICAL_SECTION(s);
+
+  return (TRUE);
+#else
+  (void)clear;
+  osal_memset(pStats, 0, sizeof(macMcuIsrStats_t));
+
+  return (FALSE);
+#endif
+}
+
+
 /**************************************************************************************************
  * @fn          macMcuRfIsr
  *
@@ -806,6 +941,9 @@ uint32 macMcuPrecisionCount(void)
 HAL_ISR_FUNCTION( macMcuRfIsr, RF_VECTOR )
 {
   uint8 rfim;
+#ifdef MAC_ISR_STATS
+  uint32 stamp;
+#endif
   
   HAL_ENTER_ISR();
 
@@ -825,7 +963,9 @@ HAL_ISR_FUNCTION( macMcuRfIsr, RF_VECTOR )
      */
     /* clear flag */
     RFIRQF1 = ~IRQ_CSP_MANINT;
+    MAC_MCU_ISR_STATS_START(stamp);
     macCspTxIntIsr();
+    MAC_MCU_ISR_STATS_STOP(MAC_MCU_ISR_CSP_TX_INT, stamp);
   }
   else if ((RFIRQF1 & IRQ_CSP_STOP) & rfim)
   {
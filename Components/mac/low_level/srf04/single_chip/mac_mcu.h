@@ -186,12 +186,59 @@
 #define MAC_MCU_CONFIG_CSP_EVENT1()           st( T2CSPCFG = 1; )
 
 
+/* ------------------------------------------------------------------------------------------------
+ *                                      ISR Statistics
+ * ------------------------------------------------------------------------------------------------
+ */
+/* slots of macMcuIsrStats_t.cycles, one per instrumented handler */
+#define MAC_MCU_ISR_RX_START          0
+#define MAC_MCU_ISR_RX_ADDR           1
+#define MAC_MCU_ISR_RX_PAYLOAD        2
+#define MAC_MCU_ISR_RX_FCS            3
+#define MAC_MCU_ISR_CSP_TX_INT        4
+#define MAC_MCU_ISR_BACKOFF_COMPARE   5
+#define MAC_MCU_ISR_NUM               6
+
+/*
+ *  Handlers are timed against the free-running MAC timer, which ticks once per CPU cycle.
+ *  Times include any nested interrupt that preempted the handler.
+ */
+#ifdef MAC_ISR_STATS
+#define MAC_MCU_ISR_STATS_START(t)        st( (t) = macMcuIsrStatsStamp(); )
+#define MAC_MCU_ISR_STATS_STOP(id, t)     macMcuIsrStatsRecord(id, t)
+#define MAC_MCU_ISR_STATS_EVENT(x)        st( macMcuIsrStats.x++; )
+#else
+#define MAC_MCU_ISR_STATS_START(t)
+#define MAC_MCU_ISR_STATS_STOP(id, t)
+#define MAC_MCU_ISR_STATS_EVENT(x)
+#endif
+
+typedef struct
+{
+  uint16 min;
+  uint16 max;
+  uint32 total;
+  uint16 count;
+} macMcuIsrCycles_t;
+
+typedef struct
+{
+  macMcuIsrCycles_t cycles[MAC_MCU_ISR_NUM];
+  uint16 rxFifoOverflow;      /* RX FIFO overflow errors */
+  uint16 lateAck;             /* ACK frames received when transmit was not listening for one */
+} macMcuIsrStats_t;
+
+
 /* ------------------------------------------------------------------------------------------------
  *                                   Global Variable Externs
  * ------------------------------------------------------------------------------------------------
  */
 extern uint8 macChipVersion;
 
+#ifdef MAC_ISR_STATS
+extern macMcuIsrStats_t macMcuIsrStats;
+#endif
+
 
 /* ------------------------------------------------------------------------------------------------
  *                                       Prototypes
@@ -212,6 +259,11 @@ MAC_INTERNAL_API int8 macMcuRecordMaxRssiStop(void);
 MAC_INTERNAL_API void macMcuRecordMaxRssiIsr(void);
 uint32 macMcuPrecisionCount(void);
 void macMcuTimer2OverflowWorkaround(void);
+#ifdef MAC_ISR_STATS
+MAC_INTERNAL_API uint32 macMcuIsrStatsStamp(void);
+MAC_INTERNAL_API void macMcuIsrStatsRecord(uint8 id, uint32 start);
+#endif
+MAC_INTERNAL_API uint8 macMcuIsrStatsRead(macMcuIsrStats_t *pStats, uint8 clear);
 
 
 /**************************************************************************************************
@@ -93,6 +93,7 @@ extern "C"
 #define MT_SYS_GET_TIME                      0x11
 #define MT_SYS_OSAL_NV_DELETE                0x12
 #define MT_SYS_OSAL_NV_LENGTH                0x13
+#define MT_SYS_SLEEP_STATS                   0x14
 
 /* AREQ to host */
 #define MT_SYS_RESET_IND                     0x80
@@ -122,6 +123,10 @@ extern "C"
 #define MT_MAC_SECURITY_GET_REQ              0x10
 #define MT_MAC_SECURITY_SET_REQ              0x11
 
+/* Low-level diagnostics SREQ */
+#define MT_MAC_ISR_STATS_REQ                 0x12
+#define MT_MAC_CSMA_STATE_REQ                0x13
+
 /* AREQ from Host */
 #define MT_MAC_ASSOCIATE_RSP                 0x50
 #define MT_MAC_ORPHAN_RSP                    0x51
@@ -338,6 +343,7 @@ extern "C"
 
 #define MT_UTIL_TEST_LOOPBACK                0x10
 #define MT_UTIL_DATA_REQ                     0x11
+#define MT_UTIL_TRAFFIC_STATS                0x12
 
 #define MT_UTIL_SRC_MATCH_ENABLE             0x20
 #define MT_UTIL_SRC_MATCH_ADD_ENTRY          0x21
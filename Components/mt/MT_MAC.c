@@ -54,6 +54,7 @@
 
 /* MAC radio */
 #include "mac_radio_defs.h"
+#include "mac_tx.h"
 
 /* Hal */
 #include "hal_uart.h"
@@ -137,6 +138,8 @@ void MT_MacScanReq(uint8 * pBuf);
 void MT_MacPollReq(uint8 *pBuf);
 void MT_MacPurgeReq(uint8 *pBuf);
 void MT_MacSetRxGainReq(uint8 *pBuf);
+void MT_MacIsrStatsReq(uint8 *pBuf);
+void MT_MacCsmaStateReq(uint8 *pBuf);
 void MT_MacAssociateRsp(uint8 *pBuf);
 void MT_MacOrphanRsp(uint8 *pBuf);
 
@@ -224,6 +227,14 @@ uint8 MT_MacCommandProcessing (uint8 *pBuf)
       MT_MacSetRxGainReq(pBuf);
       break;
 
+    case MT_MAC_ISR_STATS_REQ:
+      MT_MacIsrStatsReq(pBuf);
+      break;
+
+    case MT_MAC_CSMA_STATE_REQ:
+      MT_MacCsmaStateReq(pBuf);
+      break;
+
     case MT_MAC_ASSOCIATE_RSP:
       MT_MacAssociateRsp(pBuf);
       break;
@@ -857,6 +868,84 @@ void MT_MacSetRxGainReq(uint8 *pBuf)
   MT_BuildAndSendZToolResponse(((uint8)MT_RPC_CMD_SRSP | (uint8)MT_RPC_SYS_MAC), cmdId, 1, &retValue );
 }
 
+/***************************************************************************************************
+ * @fn      MT_MacIsrStatsReq
+ *
+ * @brief   Process MAC ISR Statistics Req command that are issued by test tool. The response is
+ *          the status, then for each instrumented handler its min, max and average cycles and
+ *          call count, then the RX FIFO overflow and late ACK counts (all UINT16).
+ *
+ * @param   pBuf - Buffer contains the data: non-zero to clear the statistics after reading them
+ *
+ * @return  void
+ ***************************************************************************************************/
+void MT_MacIsrStatsReq(uint8 *pBuf)
+{
+  macMcuIsrStats_t stats;
+  uint8 retArray[1 + (MAC_MCU_ISR_NUM * 8) + 4];
+  uint8 *pRetBuf = retArray;
+  uint8 cmdId, i;
+
+  /* Parse header */
+  cmdId = pBuf[MT_RPC_POS_CMD1];
+  pBuf += MT_RPC_FRAME_HDR_SZ;
+
+  *pRetBuf++ = macMcuIsrStatsRead(&stats, *pBuf) ? ZSuccess : ZUnsupportedMode;
+
+  for (i = 0; i < MAC_MCU_ISR_NUM; i++)
+  {
+    macMcuIsrCycles_t *pCycles = &stats.cycles[i];
+    uint16 avg = (pCycles->count) ? (uint16)(pCycles->total / pCycles->count) : 0;
+
+    *pRetBuf++ = LO_UINT16(pCycles->min);
+    *pRetBuf++ = HI_UINT16(pCycles->min);
+    *pRetBuf++ = LO_UINT16(pCycles->max);
+    *pRetBuf++ = HI_UINT16(pCycles->max);
+    *pRetBuf++ = LO_UINT16(avg);
+    *pRetBuf++ = HI_UINT16(avg);
+    *pRetBuf++ = LO_UINT16(pCycles->count);
+    *pRetBuf++ = HI_UINT16(pCycles->count);
+  }
+
+  *pRetBuf++ = LO_UINT16(stats.rxFifoOverflow);
+  *pRetBuf++ = HI_UINT16(stats.rxFifoOverflow);
+  *pRetBuf++ = LO_UINT16(stats.lateAck);
+  *pRetBuf++ = HI_UINT16(stats.lateAck);
+
+  /* Build and send back the response */
+  MT_BuildAndSendZToolResponse(((uint8)MT_RPC_CMD_SRSP | (uint8)MT_RPC_SYS_MAC), cmdId,
+                                sizeof(retArray), retArray);
+}
+
+/***************************************************************************************************
+ * @fn      MT_MacCsmaStateReq
+ *
+ * @brief   Process MAC CSMA State Req command that are issued by test tool. The response is the
+ *          status, the busy CCA and missing ACK rates (1/256 units), the escalation step and
+ *          the minBE, maxBE and maxCSMABackoffs in effect.
+ *
+ * @param   pBuf - Buffer contains the data
+ *
+ * @return  void
+ ***************************************************************************************************/
+void MT_MacCsmaStateReq(uint8 *pBuf)
+{
+  macTxCsmaState_t state;
+  uint8 retArray[7];
+
+  retArray[0] = macTxCsmaStateRead(&state) ? ZSuccess : ZUnsupportedMode;
+  retArray[1] = state.ccaBusyRate;
+  retArray[2] = state.noAckRate;
+  retArray[3] = state.step;
+  retArray[4] = state.minBe;
+  retArray[5] = state.maxBe;
+  retArray[6] = state.maxCsmaBackoffs;
+
+  /* Build and send back the response */
+  MT_BuildAndSendZToolResponse(((uint8)MT_RPC_CMD_SRSP | (uint8)MT_RPC_SYS_MAC),
+                                pBuf[MT_RPC_POS_CMD1], sizeof(retArray), retArray);
+}
+
 /***************************************************************************************************
  * @fn          MT_MacAssociateRsp
  *
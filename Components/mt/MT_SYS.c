@@ -51,6 +51,7 @@
 #include "hal_adc.h"
 #include "ZGlobals.h"
 #include "OSAL_Clock.h"
+#include "OSAL_PwrMgr.h"
 
 /***************************************************************************************************
  * MACROS
@@ -121,6 +122,9 @@ void MT_SysStackTune(uint8 *pBuf);
 void MT_SysGetDeviceInfo(uint8 *pBuf);
 void MT_SysSetUtcTime(uint8 *pBuf);
 void MT_SysGetUtcTime(void);
+#if (defined POWER_SAVING) && (HAL_SLEEP_STATS == TRUE)
+void MT_SysSleepStats(uint8 *pBuf);
+#endif
 #endif /* MT_SYS_FUNC */
 
 #if defined (MT_SYS_FUNC)
@@ -217,6 +221,12 @@ uint8 MT_SysCommandProcessing(uint8 *pBuf)
       MT_SysGetUtcTime();
       break;
 
+#if (defined POWER_SAVING) && (HAL_SLEEP_STATS == TRUE)
+    case MT_SYS_SLEEP_STATS:
+      MT_SysSleepStats(pBuf);
+      break;
+#endif
+
     default:
       status = MT_RPC_ERR_COMMAND_ID;
       break;
@@ -983,6 +993,85 @@ void MT_SysGetUtcTime(void)
     osal_mem_free( buf );
   }
 }
+
+#if (defined POWER_SAVING) && (HAL_SLEEP_STATS == TRUE)
+/***************************************************************************************************
+ * @fn      MT_SysSleepStats
+ *
+ * @brief   Report the sleep accounting: 32 kHz ticks spent in PM0, PM2 and PM3, entries into each
+ *          mode, wake ups by cause (OSAL timer, MAC timer, key, UART, other), sleeps vetoed by an
+ *          ISR, refused by the MAC or skipped as too short, then per task the milliseconds that its
+ *          power manager hold kept the idle device awake, and last the number of timer expiries
+ *          that shared another timer's wakeup within their slack. All values are little endian.
+ *
+ * @param   pBuf - pointer to the data; DAT0 non-zero restarts the accounting after the report
+ *
+ * @return  None
+ ***************************************************************************************************/
+void MT_SysSleepStats(uint8 *pBuf)
+{
+  halSleepStats_t stats;
+  uint32 holdMs[PWRMGR_TASK_MAX];
+  uint8 clear = pBuf[MT_RPC_POS_DAT0];
+  uint16 coalesced;
+  uint8 taskCnt;
+  uint8 *buf;
+  uint8 len;
+  uint8 idx;
+
+  halSleepGetStats(&stats, clear);
+  taskCnt = osal_pwrmgr_get_holds(holdMs, clear);
+  coalesced = osal_timer_coalesced(clear);
+
+  len = sizeof(stats.pmTicks) + sizeof(stats.pmCnt) + sizeof(stats.wakeCnt) + (3 * 2) +
+        1 + (taskCnt * 4) + 2;
+
+  buf = osal_mem_alloc(len);
+  if (buf)
+  {
+    uint8 *pRsp = buf;
+
+    for (idx = 0; idx < HAL_SLEEP_PM_CNT; idx++)
+    {
+      pRsp = osal_buffer_uint32(pRsp, stats.pmTicks[idx]);
+    }
+
+    for (idx = 0; idx < HAL_SLEEP_PM_CNT; idx++)
+    {
+      *pRsp++ = LO_UINT16(stats.pmCnt[idx]);
+      *pRsp++ = HI_UINT16(stats.pmCnt[idx]);
+    }
+
+    for (idx = 0; idx < HAL_SLEEP_WAKE_CNT; idx++)
+    {
+      *pRsp++ = LO_UINT16(stats.wakeCnt[idx]);
+      *pRsp++ = HI_UINT16(stats.wakeCnt[idx]);
+    }
+
+    *pRsp++ = LO_UINT16(stats.vetoIsr);
+    *pRsp++ = HI_UINT16(stats.vetoIsr);
+    *pRsp++ = LO_UINT16(stats.vetoMac);
+    *pRsp++ = HI_UINT16(stats.vetoMac);
+    *pRsp++ = LO_UINT16(stats.tooShort);
+    *pRsp++ = HI_UINT16(stats.tooShort);
+
+    *pRsp++ = taskCnt;
+    for (idx = 0; idx < taskCnt; idx++)
+    {
+      pRsp = osal_buffer_uint32(pRsp, holdMs[idx]);
+    }
+
+    *pRsp++ = LO_UINT16(coalesced);
+    *pRsp++ = HI_UINT16(coalesced);
+
+    /* Build and send back the response */
+    MT_BuildAndSendZToolResponse(((uint8)MT_RPC_CMD_SRSP | (uint8)MT_RPC_SYS_SYS),
+                                   MT_SYS_SLEEP_STATS, len, buf);
+
+    osal_mem_free(buf);
+  }
+}
+#endif
 #endif /* MT_SYS_FUNC */
 
 /***************************************************************************************************
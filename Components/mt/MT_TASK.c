@@ -62,6 +62,10 @@
 
 static void MT_ProcessIncomingCommand( mtOSALSerialData_t *msg );
 
+#if defined MT_TASK && defined MT_UART_DEFAULT_PORT
+static void MT_TransportSendCB( uint8 port, uint8 *pBuf, uint16 len );
+#endif
+
 /***************************************************************************************************
  * GLOBALS
  ***************************************************************************************************/
@@ -308,12 +312,40 @@ void MT_TransportSend(uint8 *pBuf)
 
   /* Send to UART */
 #ifdef MT_UART_DEFAULT_PORT
+  /* Let the DMA send straight from the message - MT_TransportSendCB() deallocates it */
+  if (HalUARTWriteAsync(MT_UART_DEFAULT_PORT, msgPtr, dataLen + SPI_0DATA_MSG_LEN,
+                        MT_TransportSendCB) == HAL_UART_SUCCESS)
+  {
+    return;
+  }
+
   HalUARTWrite(MT_UART_DEFAULT_PORT, msgPtr, dataLen + SPI_0DATA_MSG_LEN);
 #endif
 
   /* Deallocate */
   osal_msg_deallocate(msgPtr);
 }
+
+#ifdef MT_UART_DEFAULT_PORT
+/***************************************************************************************************
+ * @fn      MT_TransportSendCB
+ *
+ * @brief   Release a msg handed to HalUARTWriteAsync() once it has been sent
+ *
+ * @param   port - UART port
+ *          pBuf - pointer to the SOP of the msg that was sent
+ *          len - length of the msg
+ *
+ * @return  None
+ ***************************************************************************************************/
+static void MT_TransportSendCB(uint8 port, uint8 *pBuf, uint16 len)
+{
+  (void)port;
+  (void)len;
+
+  osal_msg_deallocate(pBuf);
+}
+#endif
 #endif /* MT_TASK */
 /***************************************************************************************************
  ***************************************************************************************************/
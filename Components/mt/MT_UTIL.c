@@ -69,6 +69,9 @@
 #include "AssocList.h"
 #include "ZDApp.h"
 #include "ZDSecMgr.h"
+#if defined PACKET_TRAFFIC_STATS
+#include "mac_low_level.h"
+#endif
 #endif
 /***************************************************************************************************
  * CONSTANTS
@@ -81,6 +84,22 @@
 // Status + NV id
 #define MT_APSME_LINKKEY_NV_ID_GET_RSP_LEN (MT_UTIL_STATUS_LEN + 2)
 
+#if !defined NONWK && defined PACKET_TRAFFIC_STATS
+// Status + MAC and NWK counters + routing entries + next neighbour index and neighbour count,
+// then as many neighbours as fit in one frame; the host pages through the rest.
+#define MT_UTIL_TRAFFIC_STATS_LEN   (MT_UTIL_STATUS_LEN + (9 * 4) + (11 * 4) + 3 + 2)
+#define MT_UTIL_TRAFFIC_NBR_LEN     (5 * 2)
+#define MT_UTIL_TRAFFIC_NBR_PAGE    \
+  ((MT_UART_TX_BUFF_MAX - SPI_0DATA_MSG_LEN - MT_UTIL_TRAFFIC_STATS_LEN) / MT_UTIL_TRAFFIC_NBR_LEN)
+#define MT_UTIL_TRAFFIC_NBR_DONE    0xFF
+#if (MT_UTIL_TRAFFIC_NBR_PAGE < 1)
+#error MT_UART_TX_BUFF_MAX leaves no room for a neighbour in MT_UTIL_TRAFFIC_STATS.
+#endif
+#if (MAC_STATS_NBR_NUM >= MT_UTIL_TRAFFIC_NBR_DONE)
+#error MAC_STATS_NBR_NUM must be below 255, the neighbour index is a byte.
+#endif
+#endif
+
 /***************************************************************************************************
  * LOCAL VARIABLES
  ***************************************************************************************************/
@@ -132,6 +151,9 @@ static void MT_UtilzclGeneral_KeyEstablish_InitiateKeyEstablishment(uint8 *pBuf)
 static void MT_UtilzclGeneral_KeyEstablishment_ECDSASign(uint8 *pBuf);
 #endif // ZCL_KEY_ESTABLISH
 static void MT_UtilSync(void);
+#if defined PACKET_TRAFFIC_STATS
+static void MT_UtilTrafficStats(uint8 *pBuf);
+#endif // PACKET_TRAFFIC_STATS
 #endif // !defined NONWK
 #endif // MT_UTIL_FUNC
 
@@ -278,6 +300,12 @@ uint8 MT_UtilCommandProcessing(uint8 *pBuf)
     case MT_UTIL_SYNC_REQ:
       MT_UtilSync();
       break;
+
+#if defined PACKET_TRAFFIC_STATS
+    case MT_UTIL_TRAFFIC_STATS:
+      MT_UtilTrafficStats(pBuf);
+      break;
+#endif
 #endif /* !defined NONWK */
 
     default:
@@ -1472,6 +1500,130 @@ static void MT_UtilSync(void)
 {
  MT_BuildAndSendZToolResponse(((uint8)MT_RPC_CMD_AREQ|(uint8)MT_RPC_SYS_UTIL),MT_UTIL_SYNC_REQ,0,0);
 }
+
+#if defined PACKET_TRAFFIC_STATS
+/***************************************************************************************************
+ * @fn      MT_UtilTrafficStats
+ *
+ * @brief   Report the MAC and network traffic statistics: a status byte, the MAC counters
+ *          (9 x uint32), the network counters (11 x uint32), the routing table entries now
+ *          active, in discovery and failed (3 x uint8), then a page of the tracked neighbours:
+ *          the index to ask for next (0xFF when this page is the last), the number of
+ *          neighbours in this page, and short address, tx frames, no ACK, rx frames and
+ *          duplicates of each (5 x uint16). A page holds what fits in MT_UART_TX_BUFF_MAX.
+ *          All values are little endian. On failure only the status is sent.
+ *
+ * @param   pBuf - pointer to the data; DAT0 non-zero clears the counters after the report,
+ *                 so set it on the last page only; DAT1, if present, is the neighbour index
+ *                 to start the page at, 0 when absent
+ *
+ * @return  None
+ ***************************************************************************************************/
+static void MT_UtilTrafficStats(uint8 *pBuf)
+{
+  macStats_t *pMac;
+  nwkStats_t nwk;
+  uint8 clear = pBuf[MT_RPC_POS_DAT0];
+  uint8 start = (pBuf[MT_RPC_POS_LEN] > 1) ? pBuf[MT_RPC_POS_DAT0 + 1] : 0;
+  uint8 status = ZMemError;
+  uint8 *buf;
+  uint8 len;
+  uint8 idx;
+
+  len = MT_UTIL_TRAFFIC_STATS_LEN + (MT_UTIL_TRAFFIC_NBR_PAGE * MT_UTIL_TRAFFIC_NBR_LEN);
+
+  /* Both buffers are taken before the counters are read, so a failure does not clear them */
+  pMac = osal_mem_alloc(sizeof(macStats_t));
+  buf = osal_mem_alloc(len);
+
+  if ((pMac == NULL) || (buf == NULL))
+  {
+    if (pMac)
+    {
+      osal_mem_free(pMac);
+    }
+    if (buf)
+    {
+      osal_mem_free(buf);
+    }
+
+    MT_BuildAndSendZToolResponse(((uint8)MT_RPC_CMD_SRSP | (uint8)MT_RPC_SYS_UTIL),
+                                   MT_UTIL_TRAFFIC_STATS, 1, &status);
+  }
+  else
+  {
+    uint8 *pRsp = buf;
+    uint8 nbrCnt = 0;
+
+    (void)macLowLevelStatsRead(pMac, clear);
+    (void)nwk_GetStatistics(&nwk, clear);
+
+    *pRsp++ = ZSuccess;
+
+    pRsp = osal_buffer_uint32(pRsp, pMac->txAttempts);
+    pRsp = osal_buffer_uint32(pRsp, pMac->txRetries);
+    pRsp = osal_buffer_uint32(pRsp, pMac->ccaBusy);
+    pRsp = osal_buffer_uint32(pRsp, pMac->channelAccessFailures);
+    pRsp = osal_buffer_uint32(pRsp, pMac->noAck);
+    pRsp = osal_buffer_uint32(pRsp, pMac->rxFrames);
+    pRsp = osal_buffer_uint32(pRsp, pMac->rxCrcFailures);
+    pRsp = osal_buffer_uint32(pRsp, pMac->rxFifoOverflows);
+    pRsp = osal_buffer_uint32(pRsp, pMac->rxDuplicates);
+
+    pRsp = osal_buffer_uint32(pRsp, nwk.dataRequests);
+    pRsp = osal_buffer_uint32(pRsp, nwk.dataIndications);
+    pRsp = osal_buffer_uint32(pRsp, nwk.dataConfirms);
+    pRsp = osal_buffer_uint32(pRsp, nwk.dataDelivered);
+    pRsp = osal_buffer_uint32(pRsp, nwk.apsNoAck);
+    pRsp = osal_buffer_uint32(pRsp, nwk.nwkNoRoute);
+    pRsp = osal_buffer_uint32(pRsp, nwk.macNoAck);
+    pRsp = osal_buffer_uint32(pRsp, nwk.macChannelAccessFailures);
+    pRsp = osal_buffer_uint32(pRsp, nwk.indirectOverflows);
+    pRsp = osal_buffer_uint32(pRsp, nwk.indirectExpired);
+    pRsp = osal_buffer_uint32(pRsp, nwk.otherFailures);
+
+    *pRsp++ = nwk.rtgEntriesActive;
+    *pRsp++ = nwk.rtgEntriesInDiscovery;
+    *pRsp++ = nwk.rtgEntriesFailed;
+
+    /* Only the neighbours in use are reported; the next index and the count go in front */
+    pRsp += 2;
+    for (idx = start; idx < MAC_STATS_NBR_NUM; idx++)
+    {
+      macStatsNbr_t *pNbr = &pMac->nbr[idx];
+
+      if (pNbr->shortAddr != 0xFFFF)
+      {
+        if (nbrCnt == MT_UTIL_TRAFFIC_NBR_PAGE)
+        {
+          break;
+        }
+
+        *pRsp++ = LO_UINT16(pNbr->shortAddr);
+        *pRsp++ = HI_UINT16(pNbr->shortAddr);
+        *pRsp++ = LO_UINT16(pNbr->txFrames);
+        *pRsp++ = HI_UINT16(pNbr->txFrames);
+        *pRsp++ = LO_UINT16(pNbr->noAck);
+        *pRsp++ = HI_UINT16(pNbr->noAck);
+        *pRsp++ = LO_UINT16(pNbr->rxFrames);
+        *pRsp++ = HI_UINT16(pNbr->rxFrames);
+        *pRsp++ = LO_UINT16(pNbr->duplicates);
+        *pRsp++ = HI_UINT16(pNbr->duplicates);
+        nbrCnt++;
+      }
+    }
+    buf[MT_UTIL_TRAFFIC_STATS_LEN - 2] = (idx < MAC_STATS_NBR_NUM) ? idx : MT_UTIL_TRAFFIC_NBR_DONE;
+    buf[MT_UTIL_TRAFFIC_STATS_LEN - 1] = nbrCnt;
+
+    /* Build and send back the response */
+    MT_BuildAndSendZToolResponse(((uint8)MT_RPC_CMD_SRSP | (uint8)MT_RPC_SYS_UTIL),
+                                   MT_UTIL_TRAFFIC_STATS, (uint8)(pRsp - buf), buf);
+
+    osal_mem_free(buf);
+    osal_mem_free(pMac);
+  }
+}
+#endif // PACKET_TRAFFIC_STATS
 #endif /* !defined NONWK */
 #endif /* MT_UTIL_FUNC */
 /**************************************************************************************************
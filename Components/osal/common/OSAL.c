@@ -56,6 +56,9 @@
 
 /* HAL */
 #include "hal_drivers.h"
+#if (defined HAL_DMA) && (HAL_DMA == TRUE)
+  #include "hal_dma.h"
+#endif
 
 #ifdef IAR_ARMCM3_LM
   #include "FreeRTOSConfig.h"
@@ -66,10 +69,31 @@
  * MACROS
  */
 
+// Only if HalDmaAlloc() can ever find a channel; otherwise every copy would just pay for
+// the attempt.
+#if (defined HAL_DMA) && (HAL_DMA == TRUE) && HAL_DMA_ALLOC_FREE
+  #define OSAL_DMA_COPY  TRUE
+#else
+  #define OSAL_DMA_COPY  FALSE
+#endif
+
+// A generic pointer survives the round trip through a default (XDATA) pointer only if it points
+// to XDATA; the DMA cannot reach CODE, DATA or IDATA.
+#define OSAL_DMA_IS_XDATA( p )  ((const void GENERIC *)(const uint8 *)(p) == (p))
+
 /*********************************************************************
  * CONSTANTS
  */
 
+#if OSAL_DMA_COPY
+// Copies and sets of at least this many bytes are handed to a free DMA channel. Below it the
+// descriptor setup costs more than the byte loop, which takes tens of cycles per byte through
+// generic pointers.
+#if !defined OSAL_DMA_COPY_MIN
+  #define OSAL_DMA_COPY_MIN  24
+#endif
+#endif
+
 /*********************************************************************
  * TYPEDEFS
  */
@@ -153,6 +177,14 @@ void *osal_memcpy( void *dst, const void GENERIC *src, unsigned int len )
   pSrc = src;
   pDst = dst;
 
+#if OSAL_DMA_COPY
+  if ( (len >= OSAL_DMA_COPY_MIN) && OSAL_DMA_IS_XDATA( src ) &&
+        HalDmaMemcpy( dst, (const uint8 *)src, len ) )
+  {
+    return ( pDst + len );
+  }
+#endif
+
   while ( len-- )
     *pDst++ = *pSrc++;
 
@@ -261,6 +293,13 @@ uint8 osal_memcmp( const void GENERIC *src1, const void GENERIC *src2, unsigned
  */
 void *osal_memset( void *dest, uint8 value, int len )
 {
+#if OSAL_DMA_COPY
+  if ( (len >= OSAL_DMA_COPY_MIN) && HalDmaMemset( dest, value, len ) )
+  {
+    return ( dest );
+  }
+#endif
+
   return memset( dest, value, len );
 }
 
@@ -1065,6 +1104,10 @@ void osal_run_system( void )
     tasksEvents[idx] = 0;  // Clear the Events for this task.
     HAL_EXIT_CRITICAL_SECTION(intState);
 
+#if defined( POWER_SAVING ) && ( HAL_SLEEP_STATS == TRUE )
+    osal_pwrmgr_task_run();
+#endif
+
     activeTaskID = idx;
     events = (tasksArr[idx])( idx, events );
     activeTaskID = TASK_NO_TASK;
@@ -80,6 +80,16 @@ pwrmgr_attribute_t pwrmgr_attribute;
  * LOCAL VARIABLES
  */
 
+#if defined( POWER_SAVING ) && ( HAL_SLEEP_STATS == TRUE )
+/* Time each task's hold vote kept the device awake while it was idle,
+ * the system clock when that time was last charged, and whether every
+ * OSAL pass since then found no event to run, so the span was idle.
+ */
+static uint32 pwrmgr_hold_ms[PWRMGR_TASK_MAX];
+static uint32 pwrmgr_hold_stamp;
+static uint8 pwrmgr_hold_idle;
+#endif
+
 /*********************************************************************
  * LOCAL FUNCTION PROTOTYPES
  */
@@ -184,9 +194,87 @@ void osal_pwrmgr_powerconserve( void )
 
       // Put the processor into sleep mode
       OSAL_SET_CPU_INTO_SLEEP( next );
+
+#if ( HAL_SLEEP_STATS == TRUE )
+      pwrmgr_hold_idle = FALSE;
+#endif
+    }
+#if ( HAL_SLEEP_STATS == TRUE )
+    else
+    {
+      // Charge the time since the previous idle pass to every task holding, but
+      // only if no task ran in between: time spent running events is not held.
+      // The stamp only moves when time is charged, so sub-tick passes add up.
+      uint32 now = osal_GetSystemClock();
+      uint32 elapsed = now - pwrmgr_hold_stamp;
+
+      if ( !pwrmgr_hold_idle )
+      {
+        pwrmgr_hold_stamp = now;
+        pwrmgr_hold_idle = TRUE;
+      }
+      else if ( elapsed != 0 )
+      {
+        uint16 holds = pwrmgr_attribute.pwrmgr_task_state;
+        uint8 idx;
+
+        for ( idx = 0; holds != 0; idx++, holds >>= 1 )
+        {
+          if ( holds & 0x01 )
+          {
+            pwrmgr_hold_ms[idx] += elapsed;
+          }
+        }
+        pwrmgr_hold_stamp = now;
+      }
     }
+#endif
   }
 }
+
+#if ( HAL_SLEEP_STATS == TRUE )
+/*********************************************************************
+ * @fn      osal_pwrmgr_task_run
+ * @brief   Called from the main OSAL loop when it runs a task's events,
+ *          which ends the idle span that hold votes are charged for.
+ * @param   none.
+ * @return  none.
+ */
+void osal_pwrmgr_task_run( void )
+{
+  pwrmgr_hold_idle = FALSE;
+}
+
+/*********************************************************************
+ * @fn      osal_pwrmgr_get_holds
+ * @brief   Copy out, per task, the milliseconds that its PWRMGR_HOLD
+ *          vote kept an otherwise idle device from sleeping.
+ * @param   holdMs - buffer for tasksCnt entries, may be NULL to only clear.
+ *          clear - TRUE to restart the accounting after copying it out.
+ * @return  number of entries, tasksCnt capped at PWRMGR_TASK_MAX.
+ */
+uint8 osal_pwrmgr_get_holds( uint32 *holdMs, uint8 clear )
+{
+  uint8 cnt = ( tasksCnt < PWRMGR_TASK_MAX ) ? tasksCnt : PWRMGR_TASK_MAX;
+  halIntState_t intState;
+
+  HAL_ENTER_CRITICAL_SECTION( intState );
+
+  if ( holdMs != NULL )
+  {
+    osal_memcpy( holdMs, pwrmgr_hold_ms, cnt * sizeof( uint32 ) );
+  }
+
+  if ( clear )
+  {
+    osal_memset( pwrmgr_hold_ms, 0, sizeof( pwrmgr_hold_ms ) );
+  }
+
+  HAL_EXIT_CRITICAL_SECTION( intState );
+
+  return ( cnt );
+}
+#endif
 #endif /* POWER_SAVING */
 
 /*********************************************************************
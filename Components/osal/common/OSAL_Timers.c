@@ -66,6 +66,9 @@ typedef struct
   uint16 event_flag;
   uint8  task_id;
   uint16 reloadTimeout;
+#ifdef POWER_SAVING
+  uint16 slack;
+#endif
 } osalTimerRec_t;
 
 /*********************************************************************
@@ -88,12 +91,23 @@ osalTimerRec_t *timerHead;
 // Milliseconds since last reboot
 static uint32 osal_systemClock;
 
+#ifdef POWER_SAVING
+// Timer expiries that were served by a later wakeup within their slack
+static uint16 osal_timer_deferred;
+
+// The chip slept since the previous timer update, see osal_timer_wakeup()
+static uint8 osal_timer_slept;
+#endif
+
 /*********************************************************************
  * LOCAL FUNCTION PROTOTYPES
  */
 osalTimerRec_t  *osalAddTimer( uint8 task_id, uint16 event_flag, uint16 timeout );
 osalTimerRec_t *osalFindTimer( uint8 task_id, uint16 event_flag );
 void osalDeleteTimer( osalTimerRec_t *rmTimer );
+#ifdef POWER_SAVING
+static uint16 osalTimerDeadline( osalTimerRec_t *pTimer );
+#endif
 
 /*********************************************************************
  * FUNCTIONS
@@ -136,6 +150,9 @@ osalTimerRec_t * osalAddTimer( uint8 task_id, uint16 event_flag, uint16 timeout
   {
     // Timer is found - update it.
     newTimer->timeout = timeout;
+#ifdef POWER_SAVING
+    newTimer->slack = 0;
+#endif
 
     return ( newTimer );
   }
@@ -152,6 +169,9 @@ osalTimerRec_t * osalAddTimer( uint8 task_id, uint16 event_flag, uint16 timeout
       newTimer->timeout = timeout;
       newTimer->next = (void *)NULL;
       newTimer->reloadTimeout = 0;
+#ifdef POWER_SAVING
+      newTimer->slack = 0;
+#endif
 
       // Does the timer list already exist
       if ( timerHead == NULL )
@@ -329,6 +349,45 @@ uint8 osal_stop_timerEx( uint8 task_id, uint16 event_id )
   return ( (foundTimer != NULL) ? SUCCESS : INVALID_EVENT_ID );
 }
 
+/*********************************************************************
+ * @fn      osal_timer_slack
+ *
+ * @brief
+ *
+ *   This function is called to let a running timer expire up to slack
+ *   mSecs late, so that the power manager can serve it from the wakeup
+ *   of another timer instead of waking up for it alone. The slack stays
+ *   with a reload timer across reloads and is cleared when the timer is
+ *   started again.
+ *
+ * @param   uint8 task_id - task id of the timer
+ * @param   uint16 event_id - identifier of the timer
+ * @param   uint16 slack - in milliseconds.
+ *
+ * @return  SUCCESS or INVALID_EVENT_ID
+ */
+uint8 osal_timer_slack( uint8 task_id, uint16 event_id, uint16 slack )
+{
+  halIntState_t intState;
+  osalTimerRec_t *foundTimer;
+
+  HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
+
+  foundTimer = osalFindTimer( task_id, event_id );
+#ifdef POWER_SAVING
+  if ( foundTimer )
+  {
+    foundTimer->slack = slack;
+  }
+#else
+  (void)slack;  // Timers only run late to save a wakeup.
+#endif
+
+  HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
+
+  return ( (foundTimer != NULL) ? SUCCESS : INVALID_EVENT_ID );
+}
+
 /*********************************************************************
  * @fn      osal_get_timeoutEx
  *
@@ -405,6 +464,15 @@ void osalTimerUpdate( uint16 updateTime )
   halIntState_t intState;
   osalTimerRec_t *srchTimer;
   osalTimerRec_t *prevTimer;
+#ifdef POWER_SAVING
+  osalTimerRec_t *wakeTimer = NULL;
+  uint8 expiring = 0;
+  uint8 slept = osal_timer_slept;
+
+  // Only the first update after a sleep covers the wakeup that osal_next_timeout() chose;
+  // expiries found late on any other pass were late because tasks ran, not deferred.
+  osal_timer_slept = FALSE;
+#endif
 
   HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
   // Update the system time
@@ -414,6 +482,35 @@ void osalTimerUpdate( uint16 updateTime )
   // Look for open timer slot
   if ( timerHead != NULL )
   {
+#ifdef POWER_SAVING
+    // Find the timer that osal_next_timeout() woke for, among those expiring on it:
+    // the latest one without slack, else the earliest one.
+    HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
+    for ( srchTimer = (slept ? timerHead : NULL); srchTimer != NULL; srchTimer = srchTimer->next )
+    {
+      if ( (srchTimer->timeout <= updateTime) && (srchTimer->event_flag) )
+      {
+        expiring++;
+        if ( wakeTimer == NULL )
+        {
+          wakeTimer = srchTimer;
+        }
+        else if ( wakeTimer->slack == 0 )
+        {
+          if ( (srchTimer->slack == 0) && (srchTimer->timeout > wakeTimer->timeout) )
+          {
+            wakeTimer = srchTimer;
+          }
+        }
+        else if ( (srchTimer->slack == 0) || (srchTimer->timeout < wakeTimer->timeout) )
+        {
+          wakeTimer = srchTimer;
+        }
+      }
+    }
+    HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
+#endif
+
     // Add it to the end of the timer list
     srchTimer = timerHead;
     prevTimer = (void *)NULL;
@@ -425,6 +522,15 @@ void osalTimerUpdate( uint16 updateTime )
      
       HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
       
+#ifdef POWER_SAVING
+      // Overdue within its slack and served by another timer's deadline: a wakeup saved
+      if ( (expiring > 1) && (srchTimer != wakeTimer) && (srchTimer->slack) &&
+           (srchTimer->timeout < updateTime) && (srchTimer->event_flag) )
+      {
+        osal_timer_deferred++;
+      }
+#endif
+
       if (srchTimer->timeout <= updateTime)
       {
         srchTimer->timeout = 0;
@@ -504,12 +610,35 @@ void osal_adjust_timers( void )
   }
 }
 
+/*********************************************************************
+ * @fn      osalTimerDeadline
+ *
+ * @brief   Latest time a timer may expire: its timeout plus slack.
+ *
+ * @param   pTimer - timer to check
+ *
+ * @return  uint16 - deadline, saturated at OSAL_TIMERS_MAX_TIMEOUT
+ *********************************************************************/
+static uint16 osalTimerDeadline( osalTimerRec_t *pTimer )
+{
+  if ( pTimer->slack > (OSAL_TIMERS_MAX_TIMEOUT - pTimer->timeout) )
+  {
+    return ( OSAL_TIMERS_MAX_TIMEOUT );
+  }
+
+  return ( pTimer->timeout + pTimer->slack );
+}
+
 /*********************************************************************
  * @fn      osal_next_timeout
  *
  * @brief
  *
- *   Search timer table to return the lowest timeout value. If the
+ *   Search timer table to return the time to wake up at. Timers with
+ *   slack may be served late, up to the lowest timeout plus slack, but
+ *   only to share the wakeup of a timer without slack: the latest such
+ *   timeout within that window is returned. With none in the window,
+ *   the lowest timeout is returned and nothing is deferred. If the
  *   timer list is empty, then the returned timeout will be zero.
  *
  * @param   none
@@ -519,6 +648,8 @@ void osal_adjust_timers( void )
 uint16 osal_next_timeout( void )
 {
   uint16 nextTimeout;
+  uint16 deadline;
+  uint16 plainTimeout;
   osalTimerRec_t *srchTimer;
 
   if ( timerHead != NULL )
@@ -526,17 +657,38 @@ uint16 osal_next_timeout( void )
     // Head of the timer list
     srchTimer = timerHead;
     nextTimeout = OSAL_TIMERS_MAX_TIMEOUT;
+    deadline = OSAL_TIMERS_MAX_TIMEOUT;
 
-    // Look for the next timeout timer
+    // Look for the next timeout timer and the earliest deadline
     while ( srchTimer != NULL )
     {
-      if (srchTimer->timeout < nextTimeout)
+      if ( srchTimer->timeout < nextTimeout )
       {
         nextTimeout = srchTimer->timeout;
       }
+      if ( osalTimerDeadline( srchTimer ) < deadline )
+      {
+        deadline = osalTimerDeadline( srchTimer );
+      }
       // Check next timer
       srchTimer = srchTimer->next;
     }
+
+    // Look for the latest timer without slack due by that deadline
+    plainTimeout = 0;
+    for ( srchTimer = timerHead; srchTimer != NULL; srchTimer = srchTimer->next )
+    {
+      if ( (srchTimer->slack == 0) && (srchTimer->timeout <= deadline) &&
+           (srchTimer->timeout > plainTimeout) )
+      {
+        plainTimeout = srchTimer->timeout;
+      }
+    }
+
+    if ( plainTimeout != 0 )
+    {
+      nextTimeout = plainTimeout;
+    }
   }
   else
   {
@@ -546,6 +698,56 @@ uint16 osal_next_timeout( void )
 
   return ( nextTimeout );
 }
+
+/*********************************************************************
+ * @fn      osal_timer_wakeup
+ *
+ * @brief
+ *
+ *   Called by the power management code when the chip wakes up from
+ *   a sleep, so that the next timer update counts the expiries that
+ *   were deferred to this wakeup.
+ *
+ * @param   none
+ *
+ * @return  none
+ *********************************************************************/
+void osal_timer_wakeup( void )
+{
+  osal_timer_slept = TRUE;
+}
+
+/*********************************************************************
+ * @fn      osal_timer_coalesced
+ *
+ * @brief
+ *
+ *   Report the number of timer expiries that were served late, within
+ *   their slack, by the wakeup from a sleep for another timer. A slack
+ *   timer that woke the chip by itself is not counted. Each one is a
+ *   wakeup saved.
+ *
+ * @param   uint8 clear - TRUE to restart the count.
+ *
+ * @return  uint16 - number of deferred expiries
+ *********************************************************************/
+uint16 osal_timer_coalesced( uint8 clear )
+{
+  halIntState_t intState;
+  uint16 cnt;
+
+  HAL_ENTER_CRITICAL_SECTION( intState );  // Hold off interrupts.
+
+  cnt = osal_timer_deferred;
+  if ( clear )
+  {
+    osal_timer_deferred = 0;
+  }
+
+  HAL_EXIT_CRITICAL_SECTION( intState );   // Re-enable interrupts.
+
+  return ( cnt );
+}
 #endif // POWER_SAVING
 
 /*********************************************************************
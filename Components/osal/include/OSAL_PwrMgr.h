@@ -81,6 +81,10 @@ typedef struct
 #define PWRMGR_CONSERVE 0
 #define PWRMGR_HOLD     1
 
+/* Number of tasks that pwrmgr_task_state can hold votes for.
+ */
+#define PWRMGR_TASK_MAX 16
+
 
 /*********************************************************************
  * GLOBAL VARIABLES
@@ -129,6 +133,18 @@ extern pwrmgr_attribute_t pwrmgr_attribute;
    */
   extern void osal_pwrmgr_powerconserve( void );
 
+  /*
+   * Copy out, per task, the milliseconds that its PWRMGR_HOLD vote kept
+   * an idle device from sleeping (HAL_SLEEP_STATS builds only).
+   */
+  extern uint8 osal_pwrmgr_get_holds( uint32 *holdMs, uint8 clear );
+
+  /*
+   * Ends the idle span charged to hold votes, called from the main OSAL
+   * loop when it runs a task (HAL_SLEEP_STATS builds only).
+   */
+  extern void osal_pwrmgr_task_run( void );
+
 /*********************************************************************
 *********************************************************************/
 
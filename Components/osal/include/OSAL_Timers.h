@@ -95,6 +95,11 @@ extern "C"
    */
   extern uint16 osal_get_timeoutEx( uint8 task_id, uint16 event_id );
 
+  /*
+   * Let a running Timer expire late to share another timer's wakeup.
+   */
+  extern uint8 osal_timer_slack( uint8 task_id, uint16 event_id, uint16 slack );
+
   /*
    * Simulated Timer Interrupt Service Routine
    */
@@ -134,6 +139,16 @@ extern "C"
    */
   extern uint16 osal_next_timeout( void );
 
+  /*
+   * Get the number of timer expiries served by another timer's wakeup.
+   */
+  extern uint16 osal_timer_coalesced( uint8 clear );
+
+  /*
+   * Tell the timers that the chip woke up from a sleep.
+   */
+  extern void osal_timer_wakeup( void );
+
 /*********************************************************************
 *********************************************************************/
 
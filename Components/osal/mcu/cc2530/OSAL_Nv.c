@@ -487,6 +487,9 @@ static uint16 initPage( uint8 pg, uint16 id, uint8 findDups )
  * @fn      erasePage
  *
  * @brief   Erases a page in Flash.
+ *          With HAL_FLASH_ASYNC the erase is only queued; it runs from the Hal task or when
+ *          HalFlashRead/Write next access the flash, whichever is first, so the page always
+ *          reads back erased.
  *
  * @param   pg - Valid NV page to erase.
  *
@@ -494,7 +497,11 @@ static uint16 initPage( uint8 pg, uint16 id, uint8 findDups )
  */
 static void erasePage( uint8 pg )
 {
+#if HAL_FLASH_ASYNC
+  HalFlashEraseAsync(pg, NULL);
+#else
   HalFlashErase(pg);
+#endif
 
   pgOff[pg - OSAL_NV_PAGE_BEG] = OSAL_NV_PAGE_HDR_SIZE;
   pgLost[pg - OSAL_NV_PAGE_BEG] = 0;
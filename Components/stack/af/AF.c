@@ -193,6 +193,8 @@ void afDataConfirm( uint8 endPoint, uint8 transID, ZStatus_t status )
   endPointDesc_t *epDesc;
   afDataConfirm_t *msgPtr;
 
+  nwk_UpdateDataConfirmStatistics( status );
+
   // Find the endpoint description
   epDesc = afFindEndPointDesc( endPoint );
   if ( epDesc == NULL )
@@ -250,6 +252,8 @@ void afIncomingData( aps_FrameFormat_t *aff, zAddrType_t *SrcAddress, uint16 Src
   uint8 grpEp = APS_GROUPS_EP_NOT_FOUND;
 #endif
 
+  nwk_UpdateStatistics( STAT_AF_DATA_INDICATION );
+
   if ( ((aff->FrmCtrl & APS_DELIVERYMODE_MASK) == APS_FC_DM_GROUP) )
   {
 #if !defined ( APS_NO_GROUPS )
@@ -363,7 +367,22 @@ static void afBuildMSGIncoming( aps_FrameFormat_t *aff, endPointDesc_t *epDesc,
   afIncomingMSGPacket_t *MSGpkt;
   const uint8 len = sizeof( afIncomingMSGPacket_t ) + aff->asduLength;
   uint8 *asdu = aff->asdu;
-  MSGpkt = (afIncomingMSGPacket_t *)osal_msg_allocate( len );
+#if defined ( MT_AF_CB_FUNC )
+  afIncomingMSGPacket_t mtPkt;
+  // If ZDO or SAPI have registered for this endpoint, dont intercept it here
+  const uint8 toMT = AFCB_CHECK(CB_ID_AF_DATA_IND, *(epDesc->task_id));
+
+  if ( toMT )
+  {
+    // MT only reads the indication while building its own response, so hand it the
+    // ASDU where the stack left it instead of copying it into a task message.
+    MSGpkt = &mtPkt;
+  }
+  else
+#endif
+  {
+    MSGpkt = (afIncomingMSGPacket_t *)osal_msg_allocate( len );
+  }
 
   if ( MSGpkt == NULL )
   {
@@ -388,23 +407,26 @@ static void afBuildMSGIncoming( aps_FrameFormat_t *aff, endPointDesc_t *epDesc,
   MSGpkt->cmd.TransSeqNumber = 0;
   MSGpkt->cmd.DataLength = aff->asduLength;
 
-  if ( MSGpkt->cmd.DataLength )
+  if ( MSGpkt->cmd.DataLength == 0 )
   {
-    MSGpkt->cmd.Data = (uint8 *)(MSGpkt + 1);
-    osal_memcpy( MSGpkt->cmd.Data, asdu, MSGpkt->cmd.DataLength );
+    MSGpkt->cmd.Data = NULL;
+  }
+#if defined ( MT_AF_CB_FUNC )
+  else if ( toMT )
+  {
+    MSGpkt->cmd.Data = asdu;
   }
+#endif
   else
   {
-    MSGpkt->cmd.Data = NULL;
+    MSGpkt->cmd.Data = (uint8 *)(MSGpkt + 1);
+    osal_memcpy( MSGpkt->cmd.Data, asdu, MSGpkt->cmd.DataLength );
   }
 
 #if defined ( MT_AF_CB_FUNC )
-  // If ZDO or SAPI have registered for this endpoint, dont intercept it here
-  if (AFCB_CHECK(CB_ID_AF_DATA_IND, *(epDesc->task_id)))
+  if ( toMT )
   {
     MT_AfIncomingMsg( (void *)MSGpkt );
-    // Release the memory.
-    osal_msg_deallocate( (void *)MSGpkt );
   }
   else
 #endif
@@ -618,6 +640,7 @@ afStatus_t AF_DataRequest( afAddrType_t *dstAddr, endPointDesc_t *srcEP,
 
   if ( stat == afStatus_SUCCESS )
   {
+    nwk_UpdateStatistics( STAT_AF_DATA_REQUEST );
     (*transID)++;
   }
 
@@ -292,6 +292,10 @@ CONST uint8 defaultTCLinkKey[SEC_KEY_LEN] = DEFAULT_TC_LINK_KEY;
   uint32 nwkSecurityFailures = 0;
 #endif
 
+#if defined ( PACKET_TRAFFIC_STATS )
+  nwkStats_t nwkStats;
+#endif
+
 /*********************************************************************
  * STATUS STRINGS
  */
@@ -577,6 +581,126 @@ void nwk_UpdateStatistics( uint8 statisticCode )
       break;
   }
 #endif
+
+#if defined ( PACKET_TRAFFIC_STATS )
+  switch ( statisticCode )
+  {
+    case STAT_AF_DATA_REQUEST:
+      nwkStats.dataRequests++;
+      break;
+
+    case STAT_AF_DATA_INDICATION:
+      nwkStats.dataIndications++;
+      break;
+  }
+#endif
+}
+
+/*********************************************************************
+ * @fn       nwk_UpdateDataConfirmStatistics()
+ *
+ * @brief   Count a data confirm in the traffic statistics, by status
+ *
+ * @param   status - status of the data confirm
+ *
+ * @return  none
+ */
+void nwk_UpdateDataConfirmStatistics( uint8 status )
+{
+#if defined ( PACKET_TRAFFIC_STATS )
+  nwkStats.dataConfirms++;
+
+  switch ( status )
+  {
+    case ZSuccess:
+      nwkStats.dataDelivered++;
+      break;
+
+    case ZApsNoAck:
+      nwkStats.apsNoAck++;
+      break;
+
+    case ZNwkNoRoute:
+      nwkStats.nwkNoRoute++;
+      break;
+
+    case ZMacNoACK:
+      nwkStats.macNoAck++;
+      break;
+
+    case ZMacChannelAccessFailure:
+      nwkStats.macChannelAccessFailures++;
+      break;
+
+    case ZMacTransactionOverFlow:
+      nwkStats.indirectOverflows++;
+      break;
+
+    case ZMacTransactionExpired:
+      nwkStats.indirectExpired++;
+      break;
+
+    default:
+      nwkStats.otherFailures++;
+      break;
+  }
+#else
+  (void)status;
+#endif
+}
+
+/*********************************************************************
+ * @fn       nwk_GetStatistics()
+ *
+ * @brief   Copy out the traffic statistics, with the routing table
+ *          entries counted by status at the time of the call.
+ *
+ * @param   pStats - pointer to the structure to fill in
+ * @param   clear - TRUE to restart the counters after reading
+ *
+ * @return  TRUE if built with PACKET_TRAFFIC_STATS, FALSE otherwise
+ */
+uint8 nwk_GetStatistics( nwkStats_t *pStats, uint8 clear )
+{
+#if defined ( PACKET_TRAFFIC_STATS )
+  uint16 i;
+
+  nwkStats.rtgEntriesActive = 0;
+  nwkStats.rtgEntriesInDiscovery = 0;
+  nwkStats.rtgEntriesFailed = 0;
+
+  for ( i = 0; i < gMAX_RTG_ENTRIES; i++ )
+  {
+    switch ( rtgTable[i].status )
+    {
+      case RT_ACTIVE:
+        nwkStats.rtgEntriesActive++;
+        break;
+
+      case RT_DISC:
+        nwkStats.rtgEntriesInDiscovery++;
+        break;
+
+      case RT_LINK_FAIL:
+        nwkStats.rtgEntriesFailed++;
+        break;
+    }
+  }
+
+  *pStats = nwkStats;
+
+  if ( clear )
+  {
+    osal_memset( &nwkStats, 0, sizeof( nwkStats_t ) );
+  }
+
+  return ( TRUE );
+#else
+  (void)pStats;
+  (void)clear;
+
+  return ( FALSE );
+#endif
 }
 
 /*********************************************************************
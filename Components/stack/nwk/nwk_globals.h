@@ -359,6 +359,8 @@ extern "C" {
 #define STAT_NWK_SECURITY_FAILURE       2
 #define STAT_APS_INVALID_PACKET         3
 #define STAT_APS_SECURITY_FAILURE       4
+#define STAT_AF_DATA_REQUEST            5
+#define STAT_AF_DATA_INDICATION         6
 
 // ZigBee Alliance Pre-configured TC Link Key - 'ZigBeeAlliance09'
 #define DEFAULT_TC_LINK_KEY             { 0x5a, 0x69, 0x67, 0x42, 0x65, 0x65, 0x41, 0x6c,\
@@ -368,6 +370,27 @@ extern "C" {
  * TYPEDEFS
  */
 
+// Network and APS traffic statistics, see nwk_GetStatistics()
+typedef struct
+{
+  uint32 dataRequests;              // AF data requests accepted
+  uint32 dataIndications;           // AF data indications received
+  uint32 dataConfirms;              // AF data confirms, by status below
+  uint32 dataDelivered;             // ZSuccess
+  uint32 apsNoAck;                  // ZApsNoAck - APS retries exhausted
+  uint32 nwkNoRoute;                // ZNwkNoRoute - route discovery failed
+  uint32 macNoAck;                  // ZMacNoACK - next hop did not acknowledge
+  uint32 macChannelAccessFailures;  // ZMacChannelAccessFailure
+  uint32 indirectOverflows;         // ZMacTransactionOverFlow - indirect queue full
+  uint32 indirectExpired;           // ZMacTransactionExpired - not polled in time
+  uint32 otherFailures;             // any other status
+  // Routing table entries by status at read time. This is a snapshot, not
+  // a count of discoveries - the NWK library does not report those.
+  uint8  rtgEntriesActive;
+  uint8  rtgEntriesInDiscovery;
+  uint8  rtgEntriesFailed;
+} nwkStats_t;
+
 /*********************************************************************
  * NWK GLOBAL VARIABLES
  */
@@ -470,6 +493,10 @@ extern void nwk_Status( uint16 statusCode, uint16 statusValue );
 
 extern void nwk_UpdateStatistics( uint8 statisticCode );
 
+extern void nwk_UpdateDataConfirmStatistics( uint8 status );
+
+extern uint8 nwk_GetStatistics( nwkStats_t *pStats, uint8 clear );
+
 /*********************************************************************
 *********************************************************************/
 #ifdef __cplusplus
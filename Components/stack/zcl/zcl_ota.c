@@ -111,8 +111,6 @@ static uint8 zclOTA_Permit = TRUE;
 
 #if defined OTA_MMO_SIGN
 static OTA_MmoCtrl_t zclOTA_MmoHash;
-static uint8 zclOTA_DataToHash[OTA_MMO_HASH_SIZE];
-static uint8 zclOTA_HashPos;
 static uint8 zclOTA_SignerIEEE[Z_EXTADDR_LEN];
 static uint8 zclOTA_SignatureData[OTA_SIGNATURE_LEN];
 static uint8 zclOTA_Certificate[OTA_CERTIFICATE_LEN];
@@ -1033,6 +1031,7 @@ uint8 zclOTA_ProcessImageData(uint8 *pData, uint8 len)
   int8 i;
 #if defined OTA_MMO_SIGN
   uint8 skipHash = FALSE;
+  int8 hashStart = -1;  // Start of the run of bytes in pData still to be hashed
 #endif
 
   if (zclOTA_ImageUpgradeStatus != OTA_STATUS_IN_PROGRESS)
@@ -1069,7 +1068,6 @@ uint8 zclOTA_ProcessImageData(uint8 *pData, uint8 len)
       // Initialize control variables
 #if defined OTA_MMO_SIGN
       osal_memset(&zclOTA_MmoHash, 0, sizeof(zclOTA_MmoHash));
-      zclOTA_HashPos = 0;
 #endif
 
       // Missing break intended
@@ -1237,33 +1235,28 @@ uint8 zclOTA_ProcessImageData(uint8 *pData, uint8 len)
       if (zclOTA_ElementTag != OTA_ECDSA_SIGNATURE_TAG_ID)
       {
         // This tag is not for the signature.
-        // Put the Lower byte of the tag into the hash buffer now
-        // The high byte will be processed as usual below
-        zclOTA_DataToHash[zclOTA_HashPos++] = LO_UINT16(zclOTA_ElementTag);
-
-        // When the buffer reaches OTA_MMO_HASH_SIZE, update the Hash
-        if (zclOTA_HashPos == OTA_MMO_HASH_SIZE)
-        {
-          OTA_CalculateMmoR3(&zclOTA_MmoHash, zclOTA_DataToHash, OTA_MMO_HASH_SIZE, FALSE);
-          zclOTA_HashPos = 0;
-        }
+        // Hash the Lower byte of the tag now, the tag byte before was skipped
+        // so no run is open. The high byte will be processed as usual below
+        uint8 tagLo = LO_UINT16(zclOTA_ElementTag);
+        OTA_MmoUpdate(&zclOTA_MmoHash, &tagLo, 1);
 
         skipHash = FALSE;
       }
     }
 
+    // Hash runs of bytes in one call rather than byte by byte
     if (!skipHash)
     {
-      // Maintain a buffer of data to hash
-      zclOTA_DataToHash[zclOTA_HashPos++] = pData[i];
-
-      // When the buffer reaches OTA_MMO_HASH_SIZE, update the Hash
-      if (zclOTA_HashPos == OTA_MMO_HASH_SIZE)
+      if (hashStart < 0)
       {
-        OTA_CalculateMmoR3(&zclOTA_MmoHash, zclOTA_DataToHash, OTA_MMO_HASH_SIZE, FALSE);
-        zclOTA_HashPos = 0;
+        hashStart = i;
       }
     }
+    else if (hashStart >= 0)
+    {
+      OTA_MmoUpdate(&zclOTA_MmoHash, pData + hashStart, i - hashStart);
+      hashStart = -1;
+    }
 #endif
 
     // Check if the download is complete
@@ -1273,7 +1266,12 @@ uint8 zclOTA_ProcessImageData(uint8 *pData, uint8 len)
 
 #if defined OTA_MMO_SIGN
       // Complete the hash calcualtion
-      OTA_CalculateMmoR3(&zclOTA_MmoHash, zclOTA_DataToHash, zclOTA_HashPos, TRUE);
+      if (hashStart >= 0)
+      {
+        OTA_MmoUpdate(&zclOTA_MmoHash, pData + hashStart, i + 1 - hashStart);
+        hashStart = -1;
+      }
+      OTA_MmoFinal(&zclOTA_MmoHash);
 
       // Validate the hash
       if (OTA_ValidateSignature(zclOTA_MmoHash.hash, zclOTA_Certificate,
@@ -1285,6 +1283,13 @@ uint8 zclOTA_ProcessImageData(uint8 *pData, uint8 len)
     }
   }
 
+#if defined OTA_MMO_SIGN
+  if (hashStart >= 0)
+  {
+    OTA_MmoUpdate(&zclOTA_MmoHash, pData + hashStart, len - hashStart);
+  }
+#endif
+
   return ZSuccess;
 }
 
@@ -111,6 +111,17 @@ uint16 ZDNwkMgr_LastChannelFailureRate = 0;
 
 uint8 ZDNwkMgr_NewChannel;
 
+#if defined ( ZIGBEE_CHANNEL_SURVEY )
+// Background channel survey variables
+uint8  ZDNwkMgr_ChannelOccupancy[ED_SCAN_MAXCHANNELS];
+uint8  ZDNwkMgr_SurveySamples[ED_SCAN_MAXCHANNELS];
+uint32 ZDNwkMgr_SurveyedChannels = 0;
+uint8  ZDNwkMgr_SurveyChannel = 0;
+uint8  ZDNwkMgr_SurveyInProgress = FALSE;
+uint8  ZDNwkMgr_SurveyRxFrames = 0;
+uint16 ZDNwkMgr_SurveyTxFrames = 0;
+#endif // ZIGBEE_CHANNEL_SURVEY
+
 // PAN ID Conflict variables
 #if defined ( NWK_MANAGER )
 uint8 ZDNwkMgr_PanIdUpdateInProgress = FALSE;
@@ -154,6 +165,15 @@ static void ZDNwkMgr_ProcessMgmtNwkUpdateNotify( zdoIncomingMsg_t *inMsg );
 static void ZDNwkMgr_CheckForChannelChange( ZDO_MgmtNwkUpdateNotify_t *pNotify );
 #endif // NWK_MANAGER
 
+// Background Channel Survey functions
+#if defined ( ZIGBEE_CHANNEL_SURVEY )
+static uint8 ZDNwkMgr_SurveyIdle( void );
+static uint8 ZDNwkMgr_SurveyNextChannel( void );
+static void ZDNwkMgr_SurveyUpdate( ZDNwkMgr_EDScanConfirm_t *pEDScanConfirm );
+static uint8 ZDNwkMgr_SurveyChannelBusy( void );
+static void ZDNwkMgr_SurveyCheck( void );
+#endif // ZIGBEE_CHANNEL_SURVEY
+
 // PAN ID Conflict functions
 #if defined ( NWK_MANAGER )
 void ZDNwkMgr_NetworkReportCB( ZDNwkMgr_NetworkReport_t *pReport );
@@ -202,6 +222,11 @@ void ZDNwkMgr_Init( byte task_id )
   
   ZDNwkMgr_MgmtNwkUpdateNotifyAddr.addrMode = Addr16Bit;
   ZDNwkMgr_MgmtNwkUpdateNotifyAddr.addr.shortAddr = INVALID_NODE_ADDR;
+  
+#if defined ( ZIGBEE_CHANNEL_SURVEY )
+  // Background Channel Survey initialization
+  osal_start_timerEx( ZDNwkMgr_TaskID, ZDNWKMGR_SURVEY_EVT, ZDNWKMGR_SURVEY_PERIOD );
+#endif // ZIGBEE_CHANNEL_SURVEY
 }
 
 /*********************************************************************
@@ -329,6 +354,23 @@ UINT16 ZDNwkMgr_event_loop( byte task_id, UINT16 events )
     return ( events ^ ZDNWKMGR_SCAN_REQUEST_EVT );
   }
   
+#if defined ( ZIGBEE_CHANNEL_SURVEY )
+  if ( events & ZDNWKMGR_SURVEY_EVT )
+  {
+    if ( ZDNwkMgr_SurveyNextChannel() )
+    {
+      osal_start_timerEx( ZDNwkMgr_TaskID, ZDNWKMGR_SURVEY_EVT, ZDNWKMGR_SURVEY_PERIOD );
+    }
+    else
+    {
+      // Wait for an idle gap in the traffic
+      osal_start_timerEx( ZDNwkMgr_TaskID, ZDNWKMGR_SURVEY_EVT, ZDNWKMGR_SURVEY_IDLE_CHECK );
+    }
+    
+    return ( events ^ ZDNWKMGR_SURVEY_EVT );
+  }
+#endif // ZIGBEE_CHANNEL_SURVEY
+  
   // Discard or make more handlers
   return 0;
 }
@@ -409,15 +451,34 @@ static void ZDNwkMgr_CheckForChannelChange( ZDO_MgmtNwkUpdateNotify_t *pNotify )
   uint16 failureRate;
   uint8  lowestEnergyIndex;
   uint8  lowestEnergyValue = 0xFF;
+  uint16 failureThreshold = ZDNWKMGR_CC_TX_FAILURE;
       
+#if defined ( ZIGBEE_CHANNEL_SURVEY )
+  // If our own background survey shows the current channel busy, a lower
+  // failure rate is enough to consider a channel change. The survey alone
+  // never is: some of the energy may be the network's own traffic.
+  if ( ZDNwkMgr_SurveyChannelBusy() )
+  {
+    failureThreshold = ZDNWKMGR_SURVEY_TX_FAILURE;
+  }
+#endif // ZIGBEE_CHANNEL_SURVEY
+  
   // If any device has more than 50% transmission failures, a channel
   // change should be considered
-  failureRate = ( pNotify->transmissionFailures * 100 ) / pNotify->totalTransmissions;
-  if ( failureRate < ZDNWKMGR_CC_TX_FAILURE )
+  if ( pNotify->totalTransmissions > 0 )
+  {
+    failureRate = ( pNotify->transmissionFailures * 100 ) / pNotify->totalTransmissions;
+  }
+  else
+  {
+    failureRate = 0;
+  }
+  
+  if ( failureRate < failureThreshold )
   {
 #if defined ( LCD_SUPPORTED )
     HalLcdWriteString( (char*)NwkMgrStr_1, HAL_LCD_LINE_1 );
-    HalLcdWriteStringValueValue( ": ", failureRate, 10, ZDNWKMGR_CC_TX_FAILURE, 10, HAL_LCD_LINE_2 );
+    HalLcdWriteStringValueValue( ": ", failureRate, 10, failureThreshold, 10, HAL_LCD_LINE_2 );
 #endif
     return;
   }
@@ -684,6 +745,26 @@ static void ZDNwkMgr_ProcessChannelInterference( ZDNwkMgr_ChanInterference_t *pC
  */
 static void ZDNwkMgr_ProcessEDScanConfirm( ZDNwkMgr_EDScanConfirm_t *pEDScanConfirm )
 { 
+#if defined ( ZIGBEE_CHANNEL_SURVEY )
+  // Every energy scan, requested or not, refreshes the occupancy table
+  ZDNwkMgr_SurveyUpdate( pEDScanConfirm );
+  
+  if ( ZDNwkMgr_SurveyInProgress && 
+       ( pEDScanConfirm->scannedChannels == ( (uint32)1 << ZDNwkMgr_SurveyChannel ) ) )
+  {
+    // Confirm to a background survey sample
+    ZDNwkMgr_SurveyInProgress = FALSE;
+    
+    // Once per round, when the operating channel itself has been sampled,
+    // see whether the network should move
+    if ( ZDNwkMgr_SurveyChannel == _NIB.nwkLogicalChannel )
+    {
+      ZDNwkMgr_SurveyCheck();
+    }
+    return;
+  }
+#endif // ZIGBEE_CHANNEL_SURVEY
+  
   if ( ZDNwkMgr_MgmtNwkUpdateReq.scanCount == 0xFF )
   {
     // Confirm to scan all channels for channel interference check
@@ -951,6 +1032,286 @@ void ZDNwkMgr_ProcessDataConfirm( afDataConfirm_t *afDataConfirm )
   }
 }
 
+/*********************************************************************
+ * Background Channel Survey Routines
+ */
+#if defined ( ZIGBEE_CHANNEL_SURVEY )
+/*********************************************************************
+ * @fn          ZDNwkMgr_SurveyIdle
+ *
+ * @brief       Check for an idle gap in the traffic: nothing queued for
+ *              or held in the MAC, no indirect data waiting for a poll,
+ *              and no frame sent or received since the last check.
+ *
+ * @param       none
+ *
+ * @return      TRUE if the device can leave its channel for a sample
+ */
+static uint8 ZDNwkMgr_SurveyIdle( void )
+{
+  uint8  rxFrames = ZMacRxFrameCount();
+  uint16 txFrames = _NIB.nwkTotalTransmissions;
+  uint8  idle;
+  
+  idle = ( ( nwkDB_CountTypes( NWK_DATABUF_WAITING ) == 0 ) &&
+           ( nwkDB_CountTypes( NWK_DATABUF_SENT ) == 0 ) && ZMacStateIdle() &&
+           ( nwkDB_ReturnIndirectHoldingCnt() == 0 ) &&
+           ( rxFrames == ZDNwkMgr_SurveyRxFrames ) &&
+           ( txFrames == ZDNwkMgr_SurveyTxFrames ) );
+  
+  ZDNwkMgr_SurveyRxFrames = rxFrames;
+  ZDNwkMgr_SurveyTxFrames = txFrames;
+  
+  return ( idle );
+}
+
+/*********************************************************************
+ * @fn          ZDNwkMgr_SurveyNextChannel
+ *
+ * @brief       Start a short energy scan on the next channel of the
+ *              survey round. Channels are taken in turn from the channel
+ *              list plus the operating channel. Nothing is started while
+ *              another scan is outstanding or the device is not operating
+ *              as a router or coordinator, and the sample is put off
+ *              while there is traffic.
+ *
+ * @param       none
+ *
+ * @return      FALSE if the sample was put off for traffic, TRUE otherwise
+ */
+static uint8 ZDNwkMgr_SurveyNextChannel( void )
+{
+  uint8 i;
+  uint32 channels;
+  
+  if ( ZDNwkMgr_SurveyInProgress )
+  {
+    // The last sample was never confirmed -- give up on it
+    ZDNwkMgr_SurveyInProgress = FALSE;
+    return ( TRUE );
+  }
+  
+  if ( ( ( devState != DEV_ROUTER ) && ( devState != DEV_ZB_COORD ) ) ||
+       ( ZDNwkMgr_MgmtNwkUpdateReq.scanCount != 0 ) )
+  {
+    return ( TRUE );
+  }
+  
+  if ( !ZDNwkMgr_SurveyIdle() )
+  {
+    return ( FALSE );
+  }
+  
+  channels = ( _NIB.channelList | ( (uint32)1 << _NIB.nwkLogicalChannel ) ) & MAX_CHANNELS_24GHZ;
+  
+  for ( i = 0; i < ED_SCAN_MAXCHANNELS; i++ )
+  {
+    if ( ++ZDNwkMgr_SurveyChannel >= ED_SCAN_MAXCHANNELS )
+    {
+      ZDNwkMgr_SurveyChannel = 0;
+    }
+    
+    if ( ( (uint32)1 << ZDNwkMgr_SurveyChannel ) & channels )
+    {
+      if ( NLME_EDScanRequest( (uint32)1 << ZDNwkMgr_SurveyChannel, 
+                               ZDNWKMGR_SURVEY_DURATION ) == ZSuccess )
+      {
+        ZDNwkMgr_SurveyInProgress = TRUE;
+      }
+      break;
+    }
+  }
+  
+  return ( TRUE );
+}
+
+/*********************************************************************
+ * @fn          ZDNwkMgr_SurveyUpdate
+ *
+ * @brief       Fold the energy measurements of a scan into the decaying
+ *              per-channel occupancy table.
+ *
+ * @param       pEDScanConfirm - ED Scan Confirmation message
+ *
+ * @return      none
+ */
+static void ZDNwkMgr_SurveyUpdate( ZDNwkMgr_EDScanConfirm_t *pEDScanConfirm )
+{
+  uint8 i;
+  uint32 channel;
+  
+  if ( pEDScanConfirm->status != ZSuccess )
+  {
+    return;
+  }
+  
+  for ( i = 0; i < ED_SCAN_MAXCHANNELS; i++ )
+  {
+    channel = (uint32)1 << i;
+    
+    if ( channel & pEDScanConfirm->scannedChannels )
+    {
+      if ( channel & ZDNwkMgr_SurveyedChannels )
+      {
+        ZDNwkMgr_ChannelOccupancy[i] = ZDNwkMgr_ChannelOccupancy[i]
+                 - ( ZDNwkMgr_ChannelOccupancy[i] >> ZDNWKMGR_SURVEY_DECAY_SHIFT )
+                 + ( pEDScanConfirm->energyDetectList[i] >> ZDNWKMGR_SURVEY_DECAY_SHIFT );
+      }
+      else
+      {
+        // First sample of this channel
+        ZDNwkMgr_ChannelOccupancy[i] = pEDScanConfirm->energyDetectList[i];
+        ZDNwkMgr_SurveyedChannels |= channel;
+      }
+      
+      if ( ZDNwkMgr_SurveySamples[i] < 0xFF )
+      {
+        ZDNwkMgr_SurveySamples[i]++;
+      }
+    }
+  }
+}
+
+/*********************************************************************
+ * @fn          ZDNwkMgr_SurveyChannelBusy
+ *
+ * @brief       Check the occupancy table for a busy operating channel:
+ *              sampled at least ZDNWKMGR_SURVEY_MIN_SAMPLES times, above
+ *              the acceptable energy level, with another channel of the
+ *              channel list quieter by at least ZDNWKMGR_SURVEY_MARGIN.
+ *
+ * @param       none
+ *
+ * @return      TRUE if the operating channel is busy
+ */
+static uint8 ZDNwkMgr_SurveyChannelBusy( void )
+{
+  uint8 i;
+  uint8 current;
+  uint32 channels;
+  
+  if ( ZDNwkMgr_SurveySamples[_NIB.nwkLogicalChannel] < ZDNWKMGR_SURVEY_MIN_SAMPLES )
+  {
+    return ( FALSE );
+  }
+  
+  current = ZDNwkMgr_ChannelOccupancy[_NIB.nwkLogicalChannel];
+  if ( current <= ZDNWKMGR_ACCEPTABLE_ENERGY_LEVEL )
+  {
+    return ( FALSE );
+  }
+  
+  channels = _NIB.channelList & ZDNwkMgr_SurveyedChannels;
+  
+  for ( i = 0; i < ED_SCAN_MAXCHANNELS; i++ )
+  {
+    if ( ( i != _NIB.nwkLogicalChannel ) && ( ( (uint32)1 << i ) & channels ) &&
+         ( ( (uint16)ZDNwkMgr_ChannelOccupancy[i] + ZDNWKMGR_SURVEY_MARGIN ) < current ) )
+    {
+      return ( TRUE );
+    }
+  }
+  
+  return ( FALSE );
+}
+
+/*********************************************************************
+ * @fn          ZDNwkMgr_SurveyCheck
+ *
+ * @brief       Act on a busy operating channel. The Network Manager judges
+ *              its own occupancy table as if it had been reported in a
+ *              Mgmt_NWK_Update_notify; other devices go through the usual
+ *              channel interference check, which scans all channels and
+ *              notifies the Network Manager, once their own failure rate
+ *              reaches ZDNWKMGR_SURVEY_TX_FAILURE.
+ *
+ * @param       none
+ *
+ * @return      none
+ */
+static void ZDNwkMgr_SurveyCheck( void )
+{
+  ZDNwkMgr_ChanInterference_t chanInterference;
+  
+  if ( !ZDNwkMgr_SurveyChannelBusy() )
+  {
+    return;
+  }
+  
+#if defined ( NWK_MANAGER )
+  if ( ( zgNwkMgrMode == ZDNWKMGR_ENABLE ) && 
+       ( _NIB.nwkManagerAddr == _NIB.nwkDevAddress ) )
+  {
+    uint8 i;
+    uint32 channels;
+    ZDO_MgmtNwkUpdateNotify_t *pNotify;
+    
+    pNotify = (ZDO_MgmtNwkUpdateNotify_t *)osal_mem_alloc( sizeof( ZDO_MgmtNwkUpdateNotify_t ) 
+                                                           + ED_SCAN_MAXCHANNELS );
+    if ( pNotify )
+    {
+      channels = ( _NIB.channelList | ( (uint32)1 << _NIB.nwkLogicalChannel ) ) 
+                 & ZDNwkMgr_SurveyedChannels;
+      
+      pNotify->status = ZSuccess;
+      pNotify->scannedChannels = channels;
+      pNotify->totalTransmissions = _NIB.nwkTotalTransmissions;
+      pNotify->transmissionFailures = nwkTransmissionFailures( FALSE );
+      pNotify->listCount = 0;
+      
+      for ( i = 0; i < ED_SCAN_MAXCHANNELS; i++ )
+      {
+        if ( ( (uint32)1 << i ) & channels )
+          pNotify->energyValues[pNotify->listCount++] = ZDNwkMgr_ChannelOccupancy[i];
+      }
+      
+      ZDNwkMgr_CheckForChannelChange( pNotify );
+      
+      osal_mem_free( pNotify );
+    }
+    return;
+  }
+#endif // NWK_MANAGER
+  
+  chanInterference.totalTransmissions = _NIB.nwkTotalTransmissions;
+  chanInterference.txFailures = nwkTransmissionFailures( FALSE );
+  
+  // The Network Manager would turn down a notify below this rate anyway
+  if ( ( chanInterference.totalTransmissions == 0 ) ||
+       ( ( (uint32)chanInterference.txFailures * 100 ) < 
+         ( (uint32)chanInterference.totalTransmissions * ZDNWKMGR_SURVEY_TX_FAILURE ) ) )
+  {
+    return;
+  }
+  
+  ZDNwkMgr_ProcessChannelInterference( &chanInterference );
+}
+
+/*********************************************************************
+ * @fn          ZDNwkMgr_GetChannelOccupancy
+ *
+ * @brief       Get the decaying average energy of a channel from the
+ *              background survey, in the 0x00-0xFF energy detect scale.
+ *
+ * @param       channel - channel number, 11 through 26
+ * @param       pOccupancy - pointer to put the occupancy into
+ *
+ * @return      TRUE if the channel has been sampled, FALSE otherwise
+ */
+uint8 ZDNwkMgr_GetChannelOccupancy( uint8 channel, uint8 *pOccupancy )
+{
+  if ( ( channel >= ED_SCAN_MAXCHANNELS ) || 
+       !( ( (uint32)1 << channel ) & ZDNwkMgr_SurveyedChannels ) )
+  {
+    return ( FALSE );
+  }
+  
+  *pOccupancy = ZDNwkMgr_ChannelOccupancy[channel];
+  
+  return ( TRUE );
+}
+#endif // ZIGBEE_CHANNEL_SURVEY
+
 /*********************************************************************
  * PAN ID Conflict Routines
  */
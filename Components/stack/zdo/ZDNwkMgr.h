@@ -88,9 +88,46 @@ extern "C"
 #define ZDNWKMGR_UPDATE_NOTIFY_EVT        0x0002
 #define ZDNWKMGR_UPDATE_REQUEST_EVT       0x0004
 #define ZDNWKMGR_SCAN_REQUEST_EVT         0x0008
+#define ZDNWKMGR_SURVEY_EVT               0x0010
 
 #define ZDNWKMGR_BCAST_DELIVERY_TIME      ( _NIB.BroadcastDeliveryTime * 100 )
 
+#if defined ( ZIGBEE_CHANNEL_SURVEY )
+  #if !defined ( ZIGBEE_FREQ_AGILITY )
+    #error "ZIGBEE_CHANNEL_SURVEY requires ZIGBEE_FREQ_AGILITY (router or coordinator build)"
+  #endif
+
+  // Background channel survey: one channel is energy scanned every period (ms)
+  #if !defined ( ZDNWKMGR_SURVEY_PERIOD )
+    #define ZDNWKMGR_SURVEY_PERIOD        10000
+  #endif
+
+  // Scan duration of a survey sample, 0 is about 31 ms off the operating channel
+  #define ZDNWKMGR_SURVEY_DURATION        0
+
+  // Each sample moves the occupancy 1/(2^shift) of the way to the new energy
+  #define ZDNWKMGR_SURVEY_DECAY_SHIFT     2
+
+  // Energy by which another channel must be quieter before the current
+  // channel is considered busy
+  #define ZDNWKMGR_SURVEY_MARGIN          0x10
+
+  // Samples of the operating channel needed before it can be judged busy
+  #define ZDNWKMGR_SURVEY_MIN_SAMPLES     ( 1 << ZDNWKMGR_SURVEY_DECAY_SHIFT )
+
+  // A sample is only taken in an idle gap; while there is traffic the
+  // survey looks again after this many ms
+  #if !defined ( ZDNWKMGR_SURVEY_IDLE_CHECK )
+    #define ZDNWKMGR_SURVEY_IDLE_CHECK    500
+  #endif
+
+  // Transmission failure rate (%) that, on a busy surveyed channel, is
+  // enough to consider a channel change
+  #if !defined ( ZDNWKMGR_SURVEY_TX_FAILURE )
+    #define ZDNWKMGR_SURVEY_TX_FAILURE    ( ZDNWKMGR_CC_TX_FAILURE / 2 )
+  #endif
+#endif
+
 /*********************************************************************
  * TYPEDEFS
  */
@@ -188,6 +225,14 @@ extern void (*pZDNwkMgr_EDScanConfirmCB)( NLME_EDScanConfirm_t *EDScanConfirm );
 extern void (*pZDNwkMgr_ProcessDataConfirm)( afDataConfirm_t *afDataConfirm );
 extern void (*pZDNwkMgr_ReportChannelInterference)( NLME_ChanInterference_t *chanInterference );
 
+#if defined ( ZIGBEE_CHANNEL_SURVEY )
+/*
+ * ZDNwkMgr_GetChannelOccupancy - Get the decaying average energy of a channel
+ *  from the background survey. Returns FALSE if the channel was never sampled.
+ */
+extern uint8 ZDNwkMgr_GetChannelOccupancy( uint8 channel, uint8 *pOccupancy );
+#endif
+
 // PAN ID Conflict functions
 extern void (*pZDNwkMgr_NetworkReportCB)( ZDNwkMgr_NetworkReport_t *pReport );
 extern void (*pZDNwkMgr_NetworkUpdateCB)( ZDNwkMgr_NetworkUpdate_t *pUpdate );
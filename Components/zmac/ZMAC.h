@@ -642,6 +642,11 @@ typedef enum
    */
   extern uint8 ZMacStateIdle( void );
 
+  /*
+   * This function returns a free running count of the frames received.
+   */
+  extern uint8 ZMacRxFrameCount( void );
+
   /*
    * This function sets/returns LQI adjust mode.
    */
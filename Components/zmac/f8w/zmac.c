@@ -46,6 +46,7 @@
 #include "OSAL.h"
 #include "ZMAC.h"
 #include "mac_main.h"
+#include "mac_rx.h"
 #include "ssp.h"
 
 #if !defined NONWK
@@ -708,3 +709,18 @@ uint8 ZMacStateIdle( void )
 {
   return macStateIdle();
 }
+
+/********************************************************************************************************
+ * @fn      ZMacRxFrameCount
+ *
+ * @brief   This function returns a free running count of the frames received by the radio,
+ *          to tell whether there has been any receive activity between two calls.
+ *
+ * @param   none
+ *
+ * @return  Frame count, wrapping at 0xFF.
+ ********************************************************************************************************/
+uint8 ZMacRxFrameCount( void )
+{
+  return macRxFrameCnt;
+}
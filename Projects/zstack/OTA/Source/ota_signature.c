@@ -77,11 +77,18 @@ static int OTA_ValidateHashFunc(uint8 *digest, uint32 len, uint8 *data);
  */
 void OTA_AesHashBlock(uint8 *pHash, uint8 *pData)
 {
+#ifdef _WIN32
   uint8 key[OTA_MMO_HASH_SIZE];
 
   osal_memcpy(key, pHash, OTA_MMO_HASH_SIZE);
-  osal_memcpy(pHash, pData, OTA_MMO_HASH_SIZE);
+#else
+  // The hardware encrypts with the key loaded by ssp_HW_KeyInit(), so the
+  // hash can take the data in place without a copy of the key.
+  uint8 *key = pHash;
+#endif
+
   ssp_HW_KeyInit(key);
+  osal_memcpy(pHash, pData, OTA_MMO_HASH_SIZE);
   sspAesEncryptHW(key, pHash);
   OTA_XorBlock(pHash, pData);
 }
@@ -178,6 +185,77 @@ void OTA_CalculateMmoR3(OTA_MmoCtrl_t *pCtrl, uint8 *pData, uint8 len, uint8 las
   }
 }
 
+/******************************************************************************
+ * @fn      OTA_MmoUpdate
+ *
+ * @brief   This function adds data of any length to a MMO (revision 3) Hash.
+ *          Whole blocks are hashed straight from pData; only a partial block
+ *          is copied, into the control structure, to wait for more data.
+ *
+ * @param   pCtrl - The control structure to calculate the MMO AES Hash
+ *          pData - The data
+ *          len - The length of pData
+ *
+ * @return  none
+ */
+void OTA_MmoUpdate(OTA_MmoCtrl_t *pCtrl, uint8 *pData, uint16 len)
+{
+  uint8 cnt;
+
+  if (pCtrl->pos)
+  {
+    cnt = OTA_MMO_HASH_SIZE - pCtrl->pos;
+    if (cnt > len)
+    {
+      cnt = (uint8)len;
+    }
+
+    osal_memcpy(pCtrl->buf + pCtrl->pos, pData, cnt);
+    pCtrl->pos += cnt;
+    pData += cnt;
+    len -= cnt;
+
+    if (pCtrl->pos < OTA_MMO_HASH_SIZE)
+    {
+      return;
+    }
+
+    OTA_AesHashBlock(pCtrl->hash, pCtrl->buf);
+    pCtrl->length += OTA_MMO_HASH_SIZE;
+    pCtrl->pos = 0;
+  }
+
+  while (len >= OTA_MMO_HASH_SIZE)
+  {
+    OTA_AesHashBlock(pCtrl->hash, pData);
+    pCtrl->length += OTA_MMO_HASH_SIZE;
+    pData += OTA_MMO_HASH_SIZE;
+    len -= OTA_MMO_HASH_SIZE;
+  }
+
+  if (len)
+  {
+    osal_memcpy(pCtrl->buf, pData, len);
+    pCtrl->pos = (uint8)len;
+  }
+}
+
+/******************************************************************************
+ * @fn      OTA_MmoFinal
+ *
+ * @brief   This function completes a MMO (revision 3) Hash fed by
+ *          OTA_MmoUpdate(). The digest is left in pCtrl->hash.
+ *
+ * @param   pCtrl - The control structure to calculate the MMO AES Hash
+ *
+ * @return  none
+ */
+void OTA_MmoFinal(OTA_MmoCtrl_t *pCtrl)
+{
+  OTA_CalculateMmoR3(pCtrl, pCtrl->buf, pCtrl->pos, TRUE);
+  pCtrl->pos = 0;
+}
+
 #if defined (ZCL_KEY_ESTABLISH)
 /******************************************************************************
  * @fn      OTA_ValidateHashFunc
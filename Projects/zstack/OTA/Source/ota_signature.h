@@ -59,6 +59,8 @@ typedef struct
 {
   uint8 hash[OTA_MMO_HASH_SIZE];
   uint32 length;
+  uint8 buf[OTA_MMO_HASH_SIZE];   // Partial block held by OTA_MmoUpdate()
+  uint8 pos;
 } OTA_MmoCtrl_t;
 
 
@@ -69,6 +71,8 @@ extern "C"
 
 // Entry functions
 extern void OTA_CalculateMmoR3(OTA_MmoCtrl_t *pCtrl, uint8 *pData, uint8 len, uint8 lastBlock);
+extern void OTA_MmoUpdate(OTA_MmoCtrl_t *pCtrl, uint8 *pData, uint16 len);
+extern void OTA_MmoFinal(OTA_MmoCtrl_t *pCtrl);
 extern uint8 OTA_ValidateSignature(uint8 *pHash, uint8* pCert, uint8 *pSig, uint8 *pIEEE);
 void sspMMOHash2 (uint8 *Pb, uint8 prefix, uint8 *Mb, uint16 bitlen, uint8 *Cstate);
 
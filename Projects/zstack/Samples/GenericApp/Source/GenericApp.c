@@ -49,6 +49,7 @@
 #include "ZDApp.h"
 #include "ZDObject.h"
 #include "ZDProfile.h"
+#include "ZMAC.h"
 
 #include "GenericApp.h"
 #include "DebugTrace.h"
@@ -72,6 +73,21 @@
  * CONSTANTS
  */
 
+// Frames of unexpected length in a row before the UART falls back to SERIAL_BAUD.
+#if !defined( GENERICAPP_UART_ERR_MAX )
+#define GENERICAPP_UART_ERR_MAX  3
+#endif
+
+// Channel a capture build (HAL_SNIFFER) listens on.
+#if !defined( GENERICAPP_SNIFFER_CHANNEL )
+#define GENERICAPP_SNIFFER_CHANNEL  11
+#endif
+
+// A capture build must never start the network, which would retune and filter the radio.
+#if (defined HAL_SNIFFER) && (HAL_SNIFFER == TRUE) && !defined( HOLD_AUTO_START )
+#error HAL_SNIFFER requires HOLD_AUTO_START.
+#endif
+
 /*********************************************************************
  * TYPEDEFS
  */
@@ -135,6 +151,7 @@ byte GenericApp_TransID;  // This is the unique message ID (counter)
 
 afAddrType_t GenericApp_DstAddr;
 SpO2SystemStatus_t SpO2SystemStatus;
+static uint8 GenericApp_UartErrCnt;
 /*********************************************************************
  * LOCAL FUNCTIONS
  */
@@ -145,6 +162,9 @@ void GenericApp_MessageMSGCB( afIncomingMSGPacket_t *pckt );
 void GenericApp_ProcessUartData( OSALSerialData_t *inMsg );
 void GenericApp_LeaveNetwork( void );
 void GenericApp_HandleNetworkStatus( devStates_t GenericApp_NwkStateTemp);
+#if (defined HAL_SNIFFER) && (HAL_SNIFFER == TRUE)
+static void GenericApp_SnifferStart( void );
+#endif
 /*********************************************************************
  * NETWORK LAYER CALLBACKS
  */
@@ -194,17 +214,26 @@ void GenericApp_Init( byte task_id )
   // Register for all key events - This app will handle all key events
   RegisterForKeys( GenericApp_TaskID );
 
+  SpO2SystemStatus = SpO2_OFFLINE;
+
+#if (defined HAL_SNIFFER) && (HAL_SNIFFER == TRUE)
+  // The UART was opened by the HAL for the capture stream
+  GenericApp_SnifferStart();
+#else
   // Init the UART
   Serial_Init();
   
   // Register for serial events - This app will handle all serial events
   Serial_UartRegisterTaskID( GenericApp_TaskID );
   
-  SpO2SystemStatus = SpO2_OFFLINE;
   uint8 bufferSend[3] = {DATA_START,DATA_START,DATA_END};     
   bufferSend[1] = CLOSE_NWK;
   Serial_UartSendMsg(bufferSend,3);
   
+  // Step the UART up to the fastest rate the MSP430 accepts
+  Serial_BaudNegotiate();
+#endif
+  
   // Update the display
 #if defined ( LCD_SUPPORTED )
     HalLcdWriteString( "GenericApp", HAL_LCD_LINE_1 );
@@ -300,6 +329,11 @@ UINT16 GenericApp_ProcessEvent( byte task_id, UINT16 events )
     return (events ^ SYS_EVENT_MSG);
   }
 
+  if ( events & SERIAL_BAUD_EVT )
+  {
+    Serial_BaudProcessEvent();
+    return (events ^ SERIAL_BAUD_EVT);
+  }
   
   // Discard unknown events
   return 0;
@@ -362,9 +396,15 @@ void GenericApp_ProcessZDOMsgs( zdoIncomingMsg_t *inMsg )
 /*********************************************************************
  * @fn      GenericApp_HandleKeys
  *
- * @brief   Handles all key events for this device.
+ * @brief   Handles all key events for this device. Only a plain press
+ *          of the link key acts; long and double presses are ignored.
+ *          With the key in interrupt mode, a plain press is reported
+ *          on release once HAL_KEY_DOUBLE_MSECS has passed without a
+ *          second press; build with HAL_KEY_DOUBLE_MSECS=0 to act
+ *          right on release.
  *
- * @param   shift - true if in shift/alt.
+ * @param   shift - true if in shift/alt, or'ed with HAL_KEY_STATE_LONG
+ *                  or HAL_KEY_STATE_DOUBLE for those gestures.
  * @param   keys - bit field for key events. Valid entries:
  *                 HAL_KEY_SW_4
  *                 HAL_KEY_SW_3
@@ -376,6 +416,12 @@ void GenericApp_ProcessZDOMsgs( zdoIncomingMsg_t *inMsg )
 void GenericApp_HandleKeys( byte shift, byte keys )
 {
   uint8 bufferSend[3] = {DATA_START,DATA_START,DATA_END};
+
+  if ( shift & (HAL_KEY_STATE_LONG | HAL_KEY_STATE_DOUBLE) )
+  {
+    return;
+  }
+
   if(keys & HAL_KEY_SW_6)   //Link button be pressed
   {
     if( SpO2SystemStatus == SpO2_OFFLINE ) // -->Ѱ
@@ -487,6 +533,7 @@ void GenericApp_ProcessUartData( OSALSerialData_t *inMsg )
                    pMsg,
                    &GenericApp_TransID,
                    AF_DISCV_ROUTE, AF_DEFAULT_RADIUS ); 
+    GenericApp_UartErrCnt = 0;
   }
   else if(dataLen == 10) // Ϊ10ʾͬϢ
   {
@@ -496,6 +543,13 @@ void GenericApp_ProcessUartData( OSALSerialData_t *inMsg )
                        NULL,
                        &GenericApp_TransID,
                        AF_DISCV_ROUTE, AF_DEFAULT_RADIUS );    
+      GenericApp_UartErrCnt = 0;
+  }
+  else if ( ++GenericApp_UartErrCnt >= GENERICAPP_UART_ERR_MAX )
+  {
+    // Frames are being broken up at the negotiated rate
+    GenericApp_UartErrCnt = 0;
+    Serial_BaudFallback();
   }
 }
 
@@ -550,5 +604,31 @@ void GenericApp_HandleNetworkStatus( devStates_t GenericApp_NwkStateTemp)
     Serial_UartSendMsg(bufferSend,3);
   }
 }
+
+#if (defined HAL_SNIFFER) && (HAL_SNIFFER == TRUE)
+/*********************************************************************
+ * @fn      GenericApp_SnifferStart
+ *
+ * @brief   Keep the receiver on in promiscuous mode on
+ *          GENERICAPP_SNIFFER_CHANNEL, so that the MAC hands every
+ *          frame it hears to the HAL capture stream.
+ *
+ * @param   none
+ *
+ * @return  none
+ */
+static void GenericApp_SnifferStart( void )
+{
+  uint8 value;
+
+  value = GENERICAPP_SNIFFER_CHANNEL;
+  ZMacSetReq( ZMacChannel, &value );
+
+  value = TRUE;
+  ZMacSetReq( ZMacRxOnIdle, &value );
+  ZMacSetReq( ZMacPromiscuousMode, &value );
+}
+#endif
+
 /*********************************************************************
 *********************************************************************/
@@ -73,6 +73,25 @@
 #define SERIAL_IDLE  6
 #endif
 
+// Highest rate to negotiate with the MSP430, SERIAL_BAUD disables the negotiation.
+#if !defined( SERIAL_BAUD_MAX )
+#define SERIAL_BAUD_MAX  SERIAL_BAUD
+#endif
+
+// Millisecs to wait for the MSP430 to echo a negotiation frame.
+#if !defined( SERIAL_BAUD_TIMEOUT )
+#define SERIAL_BAUD_TIMEOUT  50
+#endif
+
+// Millisecs to let the echoed request finish before switching rate.
+#define SERIAL_BAUD_SETTLE  2
+
+// Baud rate negotiation states.
+#define SERIAL_BAUD_IDLE    0
+#define SERIAL_BAUD_REQ     1
+#define SERIAL_BAUD_SWITCH  2
+#define SERIAL_BAUD_CHECK   3
+
 
 
 /***************************************************************************************************
@@ -89,11 +108,19 @@
 /* Used to indentify the application ID for osal task */
 uint8 registeredSerialTaskID;
 
+static uint8 serialBaud;        // Rate the port is open at
+static uint8 serialBaudGood;    // Last rate confirmed by the MSP430
+static uint8 serialBaudNext;    // Rate being negotiated
+static uint8 serialBaudMax;     // Lowered below a rate that failed in use
+static uint8 serialBaudState;
 
 /**************************************************************************************************
  *                                        FUNCTIONS - Local
  **************************************************************************************************/
 void Serial_UartProcesssData( uint8 port, uint8 event);
+static void Serial_Open( uint8 baud );
+static void Serial_BaudSend( uint8 cmd );
+static bool Serial_BaudProcessMsg( uint8 *msg );
 
 /**************************************************************************************************
  *                                        FUNCTIONS - API
@@ -110,17 +137,37 @@ void Serial_UartProcesssData( uint8 port, uint8 event);
  * @return  None
  **************************************************************************************************/
 void Serial_Init( void )
+{
+  /* Initialize APP ID */
+  registeredSerialTaskID = 0;
+
+  serialBaudGood  = SERIAL_BAUD;
+  serialBaudMax   = SERIAL_BAUD_MAX;
+  serialBaudState = SERIAL_BAUD_IDLE;
+
+  Serial_Open( SERIAL_BAUD );
+}
+
+/**************************************************************************************************
+ * @fn      Serial_Open
+ *
+ * @brief   Open the UART at the given rate
+ *
+ * @param   baud - HAL_UART_BR_xxx
+ *
+ * @return  None
+ **************************************************************************************************/
+static void Serial_Open( uint8 baud )
 {
   //don't care ǱʾЩãûõUART driverõġ
   //ҪBAUDӲơص
   halUARTCfg_t uartConfig;
   
-  /* Initialize APP ID */
-  registeredSerialTaskID = 0;
+  serialBaud = baud;
   
   /* UART Configuration */  
   uartConfig.configured           = TRUE;              // 2x30 don't care - see uart driver.
-  uartConfig.baudRate             = SERIAL_BAUD;       // 115200
+  uartConfig.baudRate             = baud;              // SERIAL_BAUD up to SERIAL_BAUD_MAX
   uartConfig.flowControl          = FALSE;             //رӲ
   uartConfig.flowControlThreshold = SERIAL_THRESH;     // 2x30 don't care - see uart driver.
   uartConfig.rx.maxBufSize        = SERIAL_RX_SZ;      // 2x30 don't care - see uart driver.
@@ -175,6 +222,13 @@ void Serial_UartProcesssData( uint8 port, uint8 event)
           /* Read the data of Rx buffer */
           HalUARTRead( port, msg_ptr->msg , rxBufLen );
 
+          /* Baud rate negotiation frames are consumed here */
+          if ( (rxBufLen == 3) && Serial_BaudProcessMsg( msg_ptr->msg ) )
+          {
+            osal_msg_deallocate( (uint8 *)msg_ptr );
+            return;
+          }
+
           /* Send the raw data to application...or where ever */
           osal_msg_send( registeredSerialTaskID, (uint8 *)msg_ptr );          
         }
@@ -210,5 +264,152 @@ void Serial_UartRegisterTaskID( uint8 taskID )
  ***************************************************************************************************/
 uint16 Serial_UartSendMsg( uint8 *msg , uint8 dataLen )
 {
+#if (defined HAL_SNIFFER) && (HAL_SNIFFER == TRUE)
+  // The port carries the capture stream, there is no MSP430 to talk to
+  (void)msg;
+  (void)dataLen;
+  return 0;
+#else
   return HalUARTWrite( SERIAL_PORT , msg , dataLen);
-}
\ No newline at end of file
+#endif
+}
+
+/***************************************************************************************************
+ * @fn      Serial_BaudNegotiate
+ *
+ * @brief   Ask the MSP430 to step up to the next rate, unless a negotiation is running or the
+ *          highest allowed rate is reached. Each confirmed step starts the next one.
+ *
+ * @param   void
+ *
+ * @return  void
+ ***************************************************************************************************/
+void Serial_BaudNegotiate( void )
+{
+  if ( (registeredSerialTaskID == 0) || (serialBaudState != SERIAL_BAUD_IDLE) ||
+       (serialBaudGood >= serialBaudMax) )
+  {
+    return;
+  }
+
+  serialBaudNext = serialBaudGood + 1;
+  serialBaudState = SERIAL_BAUD_REQ;
+  Serial_BaudSend( BAUD_REQ | serialBaudNext );
+  osal_start_timerEx( registeredSerialTaskID, SERIAL_BAUD_EVT, SERIAL_BAUD_TIMEOUT );
+}
+
+/***************************************************************************************************
+ * @fn      Serial_BaudProcessEvent
+ *
+ * @brief   Switch rate once the request is echoed, or give up on a step that timed out.
+ *
+ * @param   void
+ *
+ * @return  void
+ ***************************************************************************************************/
+void Serial_BaudProcessEvent( void )
+{
+  switch ( serialBaudState )
+  {
+    case SERIAL_BAUD_SWITCH:
+      Serial_Open( serialBaudNext );
+      serialBaudState = SERIAL_BAUD_CHECK;
+      Serial_BaudSend( BAUD_CHECK | serialBaudNext );
+      osal_start_timerEx( registeredSerialTaskID, SERIAL_BAUD_EVT, SERIAL_BAUD_TIMEOUT );
+      break;
+
+    case SERIAL_BAUD_CHECK:
+      // No confirmation at the new rate - the MSP430 returns to the last good rate as well.
+      Serial_Open( serialBaudGood );
+      serialBaudMax = serialBaudGood;
+      serialBaudState = SERIAL_BAUD_IDLE;
+      break;
+
+    default:
+      // The request was not echoed, so the MSP430 stays at the current rate.
+      serialBaudMax = serialBaudGood;
+      serialBaudState = SERIAL_BAUD_IDLE;
+      break;
+  }
+}
+
+/***************************************************************************************************
+ * @fn      Serial_BaudFallback
+ *
+ * @brief   Return to SERIAL_BAUD after the link failed in use and step up again, but no further
+ *          than the rate below the one that failed.
+ *
+ * @param   void
+ *
+ * @return  void
+ ***************************************************************************************************/
+void Serial_BaudFallback( void )
+{
+  if ( registeredSerialTaskID )
+  {
+    osal_stop_timerEx( registeredSerialTaskID, SERIAL_BAUD_EVT );
+  }
+
+  if ( serialBaud > SERIAL_BAUD )
+  {
+    serialBaudMax = serialBaud - 1;
+    Serial_Open( SERIAL_BAUD );
+  }
+
+  serialBaudGood = SERIAL_BAUD;
+  serialBaudState = SERIAL_BAUD_IDLE;
+  Serial_BaudNegotiate();
+}
+
+/***************************************************************************************************
+ * @fn      Serial_BaudSend
+ *
+ * @brief   Send a baud rate negotiation frame to the MSP430
+ *
+ * @param   cmd - BAUD_REQ or BAUD_CHECK with the rate in the low nibble
+ *
+ * @return  void
+ ***************************************************************************************************/
+static void Serial_BaudSend( uint8 cmd )
+{
+  uint8 bufferSend[3] = {DATA_START,DATA_START,DATA_END};
+
+  bufferSend[1] = cmd;
+  Serial_UartSendMsg( bufferSend, 3 );
+}
+
+/***************************************************************************************************
+ * @fn      Serial_BaudProcessMsg
+ *
+ * @brief   Handle the echo of a baud rate negotiation frame from the MSP430
+ *
+ * @param   msg - 3-byte frame received
+ *
+ * @return  TRUE if msg is a negotiation frame, which is not passed on to the application
+ ***************************************************************************************************/
+static bool Serial_BaudProcessMsg( uint8 *msg )
+{
+  uint8 cmd = msg[1] & BAUD_CMD_MASK;
+
+  if ( (msg[0] != DATA_START) || (msg[2] != DATA_END) ||
+       ((cmd != BAUD_REQ) && (cmd != BAUD_CHECK)) )
+  {
+    return FALSE;
+  }
+
+  if ( (serialBaudState == SERIAL_BAUD_REQ) && (msg[1] == (BAUD_REQ | serialBaudNext)) )
+  {
+    serialBaudState = SERIAL_BAUD_SWITCH;
+    osal_start_timerEx( registeredSerialTaskID, SERIAL_BAUD_EVT, SERIAL_BAUD_SETTLE );
+  }
+  else if ( (serialBaudState == SERIAL_BAUD_CHECK) && (msg[1] == (BAUD_CHECK | serialBaudNext)) )
+  {
+    osal_stop_timerEx( registeredSerialTaskID, SERIAL_BAUD_EVT );
+    serialBaudGood = serialBaudNext;
+    serialBaudState = SERIAL_BAUD_IDLE;
+    Serial_BaudNegotiate();
+  }
+
+  // Late echoes of an abandoned step are dropped as well.
+  return TRUE;
+}
@@ -79,6 +79,21 @@ typedef struct
 #define DATA_START      0x33    // ݿʼУλ
 #define DATA_END        0x55    // ݽУλ
 
+/* Baud rate negotiation with the MSP430, every frame is {DATA_START, cmd, DATA_END}:
+ *   BAUD_REQ | rate    - sent at the current rate, echoed by the MSP430 to accept; then both
+ *                        sides switch to the HAL_UART_BR_xxx rate in the low nibble.
+ *   BAUD_CHECK | rate  - sent at the new rate, echoed by the MSP430 to confirm it.
+ * A side with no confirmation within SERIAL_BAUD_TIMEOUT returns to the last confirmed rate, and
+ * a side seeing a run of bad frames returns to SERIAL_BAUD, from where the CC2530 steps up again.
+ */
+#define BAUD_REQ        0x10
+#define BAUD_CHECK      0x20
+#define BAUD_CMD_MASK   0xF0
+#define BAUD_RATE_MASK  0x0F
+
+/* Event of the registered task used to time the baud rate negotiation */
+#define SERIAL_BAUD_EVT 0x4000
+
 /**************************************************************************************************
  *                                             FUNCTIONS - API
  **************************************************************************************************/
@@ -97,6 +112,21 @@ extern void Serial_UartRegisterTaskID( uint8 taskID );
  */
 extern uint16 Serial_UartSendMsg( uint8 *msg , uint8 dataLen );
 
+/*
+ * Step the UART up towards SERIAL_BAUD_MAX as far as the MSP430 confirms
+ */
+extern void Serial_BaudNegotiate( void );
+
+/*
+ * Handle SERIAL_BAUD_EVT of the registered task
+ */
+extern void Serial_BaudProcessEvent( void );
+
+/*
+ * Return to SERIAL_BAUD after the link has been seen to fail
+ */
+extern void Serial_BaudFallback( void );
+
 #ifdef __cplusplus
 }
 #endif  
@@ -235,16 +235,16 @@ uint8 OnBoard_SendKeys( uint8 keys, uint8 state )
  * @brief   Callback service for keys
  *
  * @param   keys  - keys that were pressed
- *          state - shifted
+ *          state - shifted, plus the HAL_KEY_STATE_LONG/DOUBLE gesture
  *
  * @return  void
  *********************************************************************/
 void OnBoard_KeyCallback ( uint8 keys, uint8 state )
 {
   uint8 shift;
-  (void)state;
 
   shift = (keys & HAL_KEY_SW_6) ? true : false;
+  shift |= state & (HAL_KEY_STATE_LONG | HAL_KEY_STATE_DOUBLE);
 
   if ( OnBoard_SendKeys( keys, shift ) != ZSuccess )
   {